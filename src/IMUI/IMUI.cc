@@ -34,6 +34,62 @@ IMUI::Font(int index) {
     return state->imguiWrapper.fonts[index];
 }
 
+//------------------------------------------------------------------------------
+bool
+IMUI::FontsReady() {
+    o_assert_dbg(IsValid());
+    return state->imguiWrapper.FontsReady();
+}
+
+//------------------------------------------------------------------------------
+void
+IMUI::WaitForFonts() {
+    o_assert_dbg(IsValid());
+    state->imguiWrapper.WaitForFonts();
+}
+
+//------------------------------------------------------------------------------
+void
+IMUI::PlotLinesGPU(const char* label, const float* values, int count, float scaleMin, float scaleMax, const ImVec2& size) {
+    o_assert_dbg(IsValid());
+    state->imguiWrapper.PlotGPU(_priv::imguiPlotRenderer::Lines, label, values, count, scaleMin, scaleMax, size);
+}
+
+//------------------------------------------------------------------------------
+void
+IMUI::PlotHistogramGPU(const char* label, const float* values, int count, float scaleMin, float scaleMax, const ImVec2& size) {
+    o_assert_dbg(IsValid());
+    state->imguiWrapper.PlotGPU(_priv::imguiPlotRenderer::Histogram, label, values, count, scaleMin, scaleMax, size);
+}
+
+//------------------------------------------------------------------------------
+int
+IMUI::CreateContext(const IMUIContextSetup& setup) {
+    o_assert_dbg(IsValid());
+    return state->imguiWrapper.CreateContext(setup);
+}
+
+//------------------------------------------------------------------------------
+void
+IMUI::DestroyContext(int ctxIndex) {
+    o_assert_dbg(IsValid());
+    state->imguiWrapper.DestroyContext(ctxIndex);
+}
+
+//------------------------------------------------------------------------------
+void
+IMUI::SetContext(int ctxIndex) {
+    o_assert_dbg(IsValid());
+    state->imguiWrapper.SetContext(ctxIndex);
+}
+
+//------------------------------------------------------------------------------
+int
+IMUI::Context() {
+    o_assert_dbg(IsValid());
+    return state->imguiWrapper.Context();
+}
+
 //------------------------------------------------------------------------------
 void
 IMUI::NewFrame(Duration frameDuration) {
@@ -48,6 +104,48 @@ IMUI::NewFrame() {
     state->imguiWrapper.NewFrame(1.0f / 60.0f);
 }
 
+//------------------------------------------------------------------------------
+bool
+IMUI::NeedsUpdate() {
+    o_assert_dbg(IsValid());
+    return state->imguiWrapper.NeedsUpdate();
+}
+
+//------------------------------------------------------------------------------
+float
+IMUI::SecondsToNextUpdate() {
+    o_assert_dbg(IsValid());
+    return state->imguiWrapper.SecondsToNextUpdate();
+}
+
+//------------------------------------------------------------------------------
+void
+IMUI::RequestUpdate(int numFrames) {
+    o_assert_dbg(IsValid());
+    state->imguiWrapper.RequestUpdate(numFrames);
+}
+
+//------------------------------------------------------------------------------
+void
+IMUI::InjectInputEvent(const IMUIInputEvent& event) {
+    o_assert_dbg(IsValid());
+    state->imguiWrapper.InjectInputEvent(event);
+}
+
+//------------------------------------------------------------------------------
+void
+IMUI::LatchInput() {
+    o_assert_dbg(IsValid());
+    state->imguiWrapper.LatchInput();
+}
+
+//------------------------------------------------------------------------------
+void
+IMUI::UseGlyphs(const char* text) {
+    o_assert_dbg(IsValid());
+    state->imguiWrapper.UseGlyphs(text);
+}
+
 //------------------------------------------------------------------------------
 ImTextureID
 IMUI::AllocImage() {
@@ -69,5 +167,103 @@ IMUI::BindImage(ImTextureID img, Id texId) {
     state->imguiWrapper.BindImage(img, texId);
 }
 
+//------------------------------------------------------------------------------
+bool
+IMUI::BindImagePixels(ImTextureID img, const void* rgba8Pixels, int width, int height) {
+    o_assert_dbg(IsValid());
+    return state->imguiWrapper.BindImagePixels(img, rgba8Pixels, width, height);
+}
+
+//------------------------------------------------------------------------------
+IMUIMemoryUsage
+IMUI::MemoryUsage() {
+    o_assert_dbg(IsValid());
+    return state->imguiWrapper.MemoryUsage();
+}
+
+//------------------------------------------------------------------------------
+const IMUIFrameStats&
+IMUI::FrameStats() {
+    o_assert_dbg(IsValid());
+    return state->imguiWrapper.FrameStats();
+}
+
+//------------------------------------------------------------------------------
+int
+IMUI::NumFrameStatsHistory() {
+    o_assert_dbg(IsValid());
+    return state->imguiWrapper.NumFrameStatsHistory();
+}
+
+//------------------------------------------------------------------------------
+const IMUIFrameStats&
+IMUI::FrameStatsHistory(int framesAgo) {
+    o_assert_dbg(IsValid());
+    return state->imguiWrapper.FrameStatsHistory(framesAgo);
+}
+
+//------------------------------------------------------------------------------
+void
+IMUI::ShowStatsWindow(bool* open) {
+    o_assert_dbg(IsValid());
+    state->imguiWrapper.ShowStatsWindow(open);
+}
+
+//------------------------------------------------------------------------------
+const IMUIFontAtlasInfo&
+IMUI::FontAtlasInfo() {
+    o_assert_dbg(IsValid());
+    return state->imguiWrapper.FontAtlasInfo();
+}
+
+//------------------------------------------------------------------------------
+bool
+IMUI::BeginCapture(const char* path, bool delta) {
+    o_assert_dbg(IsValid());
+    return state->imguiWrapper.BeginCapture(path, delta);
+}
+
+//------------------------------------------------------------------------------
+void
+IMUI::EndCapture() {
+    o_assert_dbg(IsValid());
+    state->imguiWrapper.EndCapture();
+}
+
+//------------------------------------------------------------------------------
+bool
+IMUI::IsCapturing() {
+    o_assert_dbg(IsValid());
+    return state->imguiWrapper.IsCapturing();
+}
+
+//------------------------------------------------------------------------------
+bool
+IMUI::BeginReplay(const char* path) {
+    o_assert_dbg(IsValid());
+    return state->imguiWrapper.BeginReplay(path);
+}
+
+//------------------------------------------------------------------------------
+bool
+IMUI::ReplayFrame() {
+    o_assert_dbg(IsValid());
+    return state->imguiWrapper.ReplayFrame();
+}
+
+//------------------------------------------------------------------------------
+const IMUIFrameStats&
+IMUI::ReplayFrameStats() {
+    o_assert_dbg(IsValid());
+    return state->imguiWrapper.ReplayFrameStats();
+}
+
+//------------------------------------------------------------------------------
+void
+IMUI::EndReplay() {
+    o_assert_dbg(IsValid());
+    state->imguiWrapper.EndReplay();
+}
+
 } // namespace Oryol
 
@@ -13,8 +13,11 @@
 #include "Core/Types.h"
 #include "IMUI/imguiWrapper.h"
 #include "IMUI/IMUISetup.h"
+#include "IMUI/IMUITypes.h"
+#include "IMUI/IMUITable.h"
 #include "Core/Time/Duration.h"
 #include "Resource/Id.h"
+#include <cfloat>
 
 namespace Oryol {
 
@@ -28,6 +31,13 @@ public:
     static bool IsValid();
     /// get pointer to Imgui font by index (same order in IMUISetup, can return nullptr)
     static ImFont* Font(int fontIndex);
+    /// return true when the setup fonts are ready (only false while IMUISetup::AsyncFontBake is baking)
+    static bool FontsReady();
+    /// block until the setup fonts are ready and swap them in (call outside of NewFrame/Render)
+    static void WaitForFonts();
+
+    /// make sure the glyphs in an UTF-8 string are in the font atlas (with IMUISetup::DynamicGlyphs)
+    static void UseGlyphs(const char* text);
 
     /// grab a new ImTextureID
     static ImTextureID AllocImage();
@@ -35,11 +45,65 @@ public:
     static void FreeImage(ImTextureID img);
     /// associate an ImTextureID with an Oryol texture
     static void BindImage(ImTextureID img, Id texId);
+    /// copy small RGBA8 image into the image atlas, returns false if it doesn't fit (use BindImage() then)
+    static bool BindImagePixels(ImTextureID img, const void* rgba8Pixels, int width, int height);
+
+    /// get the current memory usage of the IMUI module
+    static IMUIMemoryUsage MemoryUsage();
+    /// get counters and timings of the current frame (complete after ImGui::Render())
+    static const IMUIFrameStats& FrameStats();
+    /// get information about the font atlas (size, cache hit, setup time)
+    static const IMUIFontAtlasInfo& FontAtlasInfo();
+    /// get number of completed frames in the frame stats history
+    static int NumFrameStatsHistory();
+    /// get frame stats of a completed frame (0 is the most recent)
+    static const IMUIFrameStats& FrameStatsHistory(int framesAgo);
+    /// draw an ImGui window with frame stats and graphs (call between NewFrame and Render)
+    static void ShowStatsWindow(bool* open=nullptr);
+
+    /// plot a (large) sample array as lines which are placed on the GPU, one instance per segment
+    static void PlotLinesGPU(const char* label, const float* values, int count, float scaleMin=FLT_MAX, float scaleMax=FLT_MAX, const ImVec2& size=ImVec2(0, 0));
+    /// plot a (large) sample array as bars which are placed on the GPU, one instance per bar
+    static void PlotHistogramGPU(const char* label, const float* values, int count, float scaleMin=FLT_MAX, float scaleMax=FLT_MAX, const ImVec2& size=ImVec2(0, 0));
+
+    /// create an additional ImGui context (e.g. for an offscreen panel), returns context index
+    static int CreateContext(const IMUIContextSetup& setup=IMUIContextSetup());
+    /// destroy an additional context (must not be current)
+    static void DestroyContext(int ctxIndex);
+    /// make a context current (the default context is 0)
+    static void SetContext(int ctxIndex);
+    /// get the current context index
+    static int Context();
+
+    /// start writing each rendered frame of the current context to a capture file
+    static bool BeginCapture(const char* path, bool delta=true);
+    /// stop writing frames to the capture file
+    static void EndCapture();
+    /// return true if frames are currently captured
+    static bool IsCapturing();
+    /// open a capture file for replay, frames are replayed through an internal context with its own stream meshes
+    static bool BeginReplay(const char* path);
+    /// render the next captured frame into the current pass, returns false at the end of the capture
+    static bool ReplayFrame();
+    /// get the frame stats of the last replayed frame
+    static const IMUIFrameStats& ReplayFrameStats();
+    /// close the replayed capture file
+    static void EndReplay();
 
     /// start new ImGui frame, with frame time
     static void NewFrame(Duration frameDuration);
     /// start new ImGui frame, with fixed 1/60sec frametime
     static void NewFrame();
+    /// return true if the UI must be updated (input, animation, or requested)
+    static bool NeedsUpdate();
+    /// return seconds until the UI must be updated next (0 means now)
+    static float SecondsToNextUpdate();
+    /// request UI updates for the next N frames (e.g. after app data changed)
+    static void RequestUpdate(int numFrames=1);
+    /// queue an input event for the current context, applied in order in the next NewFrame()
+    static void InjectInputEvent(const IMUIInputEvent& event);
+    /// apply mouse moves queued since NewFrame() right before ImGui::Render() (updates the software cursor)
+    static void LatchInput();
 
 private:
     struct _state {
@@ -7,6 +7,8 @@
 #include "Core/String/String.h"
 #include "Core/Containers/StaticArray.h"
 #include "Core/Assertion.h"
+#include "Gfx/GfxTypes.h"
+#include <functional>
 
 namespace Oryol {
 
@@ -16,6 +18,69 @@ public:
     String IniFilename;
     /// set optional LogFilename, same rules as IniFilename (but also see ImGui::LogToFile())
     String LogFilename;
+    /// bake the font atlas into a single-channel texture (4x less memory than RGBA8)
+    bool Alpha8FontAtlas = false;
+    /// number of frames a vertex/index stream chunk may stay oversized before it shrinks
+    int StreamIdleFrames = 600;
+    /// initial vertex and index capacity of stream meshes and staging buffers
+    int InitialVertexCapacity = 4 * 1024;
+    int InitialIndexCapacity = 8 * 1024;
+    /// max vertex and index capacity of a single stream mesh and the staging buffers
+    int MaxVertexCapacity = 64 * 1024;
+    int MaxIndexCapacity = 128 * 1024;
+    /// optional user-provided memory for the staging buffers (must outlive IMUI)
+    void* StagingArena = nullptr;
+    int StagingArenaSize = 0;
+    /// number of stream meshes per stream chunk which are rotated through each frame (1..4),
+    /// the GL and Metal backends already multi-buffer Usage::Stream meshes internally,
+    /// so values > 1 mostly add memory there
+    int NumStreamBuffers = 1;
+    /// skip the vertex/index upload when the UI geometry didn't change since the last frame
+    bool RetainUnchangedFrames = false;
+    /// IMUI::NeedsUpdate() stays true for this long after the last input
+    float IdleDelaySeconds = 0.5f;
+    /// number of worker threads for vertex/index assembly (0 = assemble on the calling thread)
+    int NumAssemblyWorkers = 0;
+    /// min number of vertices in a stream chunk before assembly is spread over the workers
+    int ParallelAssemblyMinVertices = 32 * 1024;
+    /// optional baked font atlas cache from a previous run (e.g. a memory-mapped file, only read during IMUI::Setup())
+    const void* FontCacheData = nullptr;
+    int FontCacheSize = 0;
+    /// called during IMUI::Setup() with a newly baked font atlas cache if FontCacheData was missing or stale
+    std::function<void(const void* data, int size)> FontCacheWriteFunc;
+    /// only bake Latin-1 up front, other glyphs in the font ranges are baked when used (see IMUI::UseGlyphs()),
+    /// each frame which adds new glyphs re-bakes the complete font atlas and re-creates the font texture
+    bool DynamicGlyphs = false;
+    /// max number of glyphs added on demand, the least recently used glyphs are evicted (a linear scan per evicted glyph)
+    int MaxDynamicGlyphs = 2048;
+    /// bake the setup fonts once as a distance field and scale them to font_height (single-channel atlas, not with
+    /// DynamicGlyphs), ImGui's default font and the mouse cursors stay plain coverage bitmaps; on GLES2/WebGL1
+    /// (no fwidth()) the edges get a constant antialiasing width which fits the smallest font_height
+    bool SDFFonts = false;
+    /// pixel height at which distance field fonts are baked
+    float SDFBakeHeight = 32.0f;
+    /// distance range in atlas pixels covered by the distance field on each side of the glyph outline
+    int SDFSpread = 4;
+    /// bake the setup fonts on a background thread, IMUI::Font() returns the default font until IMUI::FontsReady()
+    bool AsyncFontBake = false;
+    /// pack small images registered with IMUI::BindImagePixels() into shared atlas textures
+    bool ImageAtlas = false;
+    /// width and height of an image atlas page in pixels
+    int ImageAtlasPageSize = 1024;
+    /// max width or height of an image that goes into the image atlas
+    int ImageAtlasMaxImageSize = 64;
+    /// max number of image atlas pages
+    int ImageAtlasMaxPages = 4;
+    /// upload compact 12-byte vertices (int16 position in 1/4 pixels, 16-bit uv) instead of 20-byte ImDrawVerts
+    bool CompactVertices = false;
+    /// give big draw lists their own stream chunk and upload them straight from the draw list (no staging copy)
+    bool ZeroCopyUpload = false;
+    /// min number of vertices in a draw list for ZeroCopyUpload, smaller draw lists share stream chunks
+    int ZeroCopyMinVertices = 8 * 1024;
+    /// forward Oryol Input as timestamped events instead of the input state at IMUI::NewFrame() (see IMUIInputEvent)
+    bool InputEventQueue = false;
+    /// max number of input events queued per context, the oldest events are dropped
+    int MaxQueuedInputEvents = 256;
     /// add TTF font from static in-memory data
     void AddFontFromMemory(void* ttf_data, int ttf_size, float font_height);
     void AddFontFromMemory(void* ttf_data, int ttf_size, float font_height, ImFontConfig* config);
@@ -60,5 +125,25 @@ IMUISetup::AddFontFromMemory(void* ttf_data, const int ttf_size, const float fon
     this->fonts[this->numFonts++] = desc;
 }
 
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::IMUIContextSetup
+    @brief setup options for additional IMUI contexts (see IMUI::CreateContext())
+*/
+class IMUIContextSetup {
+public:
+    /// forward Oryol Input to this context in IMUI::NewFrame(), if false
+    /// the app writes input into ImGui::GetIO() before IMUI::NewFrame()
+    bool ReceiveInput = true;
+    /// display size of the context in pixels (0: size of the current pass)
+    int Width = 0;
+    int Height = 0;
+    /// render target format of the pass the context is rendered into, with ColorFormat
+    /// InvalidPixelFormat all three are taken from Gfx::DisplayAttrs() (pipelines are
+    /// created once per distinct format and shared between contexts)
+    PixelFormat::Code ColorFormat = PixelFormat::InvalidPixelFormat;
+    PixelFormat::Code DepthFormat = PixelFormat::InvalidPixelFormat;
+    int SampleCount = 1;
+};
 
 } // namespace Oryol
@@ -0,0 +1,631 @@
+//------------------------------------------------------------------------------
+//  IMUITable.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "IMUITable.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+namespace Oryol {
+
+// the cancel flag of an update is checked every few rows or comparisons
+static const int CancelCheckInterval = 1024;
+// sorting starts with stable-sorted blocks of this many rows
+static const size_t SortBlockSize = 256;
+
+//------------------------------------------------------------------------------
+static void
+toLower(const char* src, char* dst, int dstSize) {
+    int i = 0;
+    for (; src[i] && (i < (dstSize - 1)); i++) {
+        dst[i] = (char) tolower((unsigned char)src[i]);
+    }
+    dst[i] = 0;
+}
+
+//------------------------------------------------------------------------------
+static bool
+containsNoCase(const char* str, const char* lowerSub) {
+    if (0 == lowerSub[0]) {
+        return true;
+    }
+    for (; *str; str++) {
+        int i = 0;
+        while (lowerSub[i] && (tolower((unsigned char)str[i]) == lowerSub[i])) {
+            i++;
+        }
+        if (0 == lowerSub[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+template<class LESS, class FLAG> static bool
+mergeRows(const int* a, const int* aEnd, const int* b, const int* bEnd, int* out, const LESS& less, const FLAG& cancelled) {
+    // stable merge of two sorted runs, returns false if cancelled
+    int n = 0;
+    while ((a != aEnd) && (b != bEnd)) {
+        if ((0 == (++n % CancelCheckInterval)) && cancelled) {
+            return false;
+        }
+        *out++ = less(*b, *a) ? *b++ : *a++;
+    }
+    out = std::copy(a, aEnd, out);
+    std::copy(b, bEnd, out);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class LESS, class FLAG> static bool
+sortRows(std::vector<int>& rows, const LESS& less, const FLAG& cancelled) {
+    // a stable bottom-up merge sort which can be cancelled between
+    // blocks and while merging (std::stable_sort can't be interrupted,
+    // and comparisons may format cell texts), returns false if cancelled
+    const size_t num = rows.size();
+    for (size_t lo = 0; lo < num; lo += SortBlockSize) {
+        if (cancelled) {
+            return false;
+        }
+        std::stable_sort(rows.begin() + lo, rows.begin() + std::min(lo + SortBlockSize, num), less);
+    }
+    if (num <= SortBlockSize) {
+        return true;
+    }
+    std::vector<int> tmp(num);
+    for (size_t width = SortBlockSize; width < num; width *= 2) {
+        const int* src = rows.data();
+        for (size_t lo = 0; lo < num; lo += 2 * width) {
+            const size_t mid = std::min(lo + width, num);
+            const size_t hi = std::min(lo + 2 * width, num);
+            if (!mergeRows(src + lo, src + mid, src + mid, src + hi, tmp.data() + lo, less, cancelled)) {
+                return false;
+            }
+        }
+        rows.swap(tmp);
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+int
+IMUITableSource::CompareRows(int rowA, int rowB, int column) const {
+    char bufA[IMUITable::MaxCellChars];
+    char bufB[IMUITable::MaxCellChars];
+    this->FormatCell(rowA, column, bufA, sizeof(bufA));
+    this->FormatCell(rowB, column, bufB, sizeof(bufB));
+    return strcmp(bufA, bufB);
+}
+
+//------------------------------------------------------------------------------
+bool
+IMUITableSource::MatchRow(int row, const char* lowerCaseFilter) const {
+    char buf[IMUITable::MaxCellChars];
+    const int numColumns = this->NumColumns();
+    for (int column = 0; column < numColumns; column++) {
+        this->FormatCell(row, column, buf, sizeof(buf));
+        if (containsNoCase(buf, lowerCaseFilter)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+IMUITable::~IMUITable() {
+    if (this->IsValid()) {
+        this->Discard();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+IMUITable::Setup(const IMUITableSource* source_) {
+    o_assert_dbg(!this->IsValid());
+    o_assert_dbg(source_);
+    this->source = source_;
+    this->numColumns = source_->NumColumns();
+    o_assert((this->numColumns > 0) && (this->numColumns <= MaxColumns));
+    this->indices.clear();
+    this->indicesView = view();
+    this->wantedView = view();
+    this->numRowsIndexed = 0;
+    this->rebuildRequested = false;
+    this->selectedRow = -1;
+    this->filterBuf[0] = 0;
+    this->clearCells();
+}
+
+//------------------------------------------------------------------------------
+void
+IMUITable::Discard() {
+    o_assert_dbg(this->IsValid());
+    this->cancelJob();
+    #if ORYOL_HAS_THREADS
+    if (this->thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->stopRequested = true;
+        }
+        this->cond.notify_all();
+        this->thread.join();
+        this->stopRequested = false;
+    }
+    #endif
+    this->indices.clear();
+    this->clearCells();
+    this->source = nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool
+IMUITable::IsValid() const {
+    return nullptr != this->source;
+}
+
+//------------------------------------------------------------------------------
+void
+IMUITable::SetFilter(const char* filter) {
+    o_assert_dbg(filter);
+    char lowerFilter[MaxFilterChars];
+    toLower(filter, lowerFilter, sizeof(lowerFilter));
+    if (0 != strcmp(lowerFilter, this->wantedView.filter)) {
+        Memory::Copy(lowerFilter, this->wantedView.filter, sizeof(lowerFilter));
+        if (filter != this->filterBuf) {
+            snprintf(this->filterBuf, sizeof(this->filterBuf), "%s", filter);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+IMUITable::SortBy(int column, bool ascending) {
+    o_assert_dbg((column >= -1) && (column < this->numColumns));
+    this->wantedView.sortColumn = column;
+    this->wantedView.ascending = ascending;
+}
+
+//------------------------------------------------------------------------------
+void
+IMUITable::Invalidate() {
+    this->rebuildRequested = true;
+    this->clearCells();
+}
+
+//------------------------------------------------------------------------------
+bool
+IMUITable::IsBusy() const {
+    return nullptr != this->curJob;
+}
+
+//------------------------------------------------------------------------------
+int
+IMUITable::NumDisplayRows() const {
+    return int(this->indices.size());
+}
+
+//------------------------------------------------------------------------------
+int
+IMUITable::DisplayRow(int displayIndex) const {
+    return this->indices[displayIndex];
+}
+
+//------------------------------------------------------------------------------
+int
+IMUITable::SelectedRow() const {
+    return this->selectedRow;
+}
+
+//------------------------------------------------------------------------------
+void
+IMUITable::update() {
+    // pick up a finished update, the result of a cancelled update
+    // is dropped since the wanted state has changed meanwhile (a
+    // dropped rebuild must be requested again, the current index
+    // array is still stale)
+    if (this->curJob && this->curJob->done) {
+        if (!this->curJob->cancelled) {
+            if (this->curJob->append) {
+                this->mergeAppended(this->curJob);
+            }
+            else {
+                this->indices.swap(this->curJob->result);
+            }
+            this->indicesView = this->curJob->target;
+            this->numRowsIndexed = this->curJob->endRow;
+        }
+        else if (this->curJob->rebuild) {
+            this->rebuildRequested = true;
+        }
+        Memory::Delete(this->curJob);
+        this->curJob = nullptr;
+    }
+
+    // a running update which doesn't produce the wanted state
+    // anymore is cancelled, the next one starts when it's done
+    const bool viewChanged = (0 != strcmp(this->wantedView.filter, this->indicesView.filter)) ||
+        (this->wantedView.sortColumn != this->indicesView.sortColumn) ||
+        (this->wantedView.ascending != this->indicesView.ascending);
+    if (this->curJob) {
+        const view& target = this->curJob->target;
+        if (this->rebuildRequested ||
+            (0 != strcmp(this->wantedView.filter, target.filter)) ||
+            (this->wantedView.sortColumn != target.sortColumn) ||
+            (this->wantedView.ascending != target.ascending)) {
+            this->curJob->cancelled = true;
+        }
+    }
+    else if (this->rebuildRequested || viewChanged || (this->source->NumRows() > this->numRowsIndexed)) {
+        // the running rebuild covers the request, unless it's cancelled
+        this->startJob(this->rebuildRequested);
+        this->rebuildRequested = false;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+IMUITable::startJob(bool rebuild) {
+    o_assert_dbg(nullptr == this->curJob);
+    job* j = Memory::New<job>();
+    j->source = this->source;
+    j->target = this->wantedView;
+    j->base = &this->indices;
+    j->endRow = this->source->NumRows();
+    j->rebuild = rebuild;
+
+    const view& cur = this->indicesView;
+    const view& want = this->wantedView;
+    const bool sameSort = (want.sortColumn == cur.sortColumn) && (want.ascending == cur.ascending);
+    if (rebuild) {
+        // start over with all rows
+        j->base = nullptr;
+        j->firstRow = 0;
+    }
+    else if (0 == strcmp(want.filter, cur.filter)) {
+        // rows were appended and/or the sort order changed, the
+        // filtered rows are kept and only re-sorted if needed,
+        // appended rows alone are merged in place
+        j->append = sameSort;
+        j->sortBase = !sameSort;
+        j->firstRow = this->numRowsIndexed;
+    }
+    else if (strstr(want.filter, cur.filter)) {
+        // a narrower filter only needs to test the rows which
+        // passed the current filter
+        j->testBase = true;
+        j->sortBase = !sameSort;
+        j->firstRow = this->numRowsIndexed;
+    }
+    else {
+        j->base = nullptr;
+        j->firstRow = 0;
+    }
+    this->curJob = j;
+
+    #if ORYOL_HAS_THREADS
+    if (!this->thread.joinable()) {
+        this->thread = std::thread(&IMUITable::workerLoop, this);
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->queuedJob = j;
+    }
+    this->cond.notify_all();
+    #else
+    runJob(j);
+    j->done = true;
+    #endif
+}
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+void
+IMUITable::workerLoop() {
+    for (;;) {
+        job* j = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->cond.wait(lock, [this] {
+                return this->stopRequested || (nullptr != this->queuedJob);
+            });
+            if (this->stopRequested) {
+                return;
+            }
+            j = this->queuedJob;
+            this->queuedJob = nullptr;
+        }
+        runJob(j);
+        // the job may be deleted by the main thread right after this
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            j->done = true;
+        }
+        this->cond.notify_all();
+    }
+}
+#endif
+
+//------------------------------------------------------------------------------
+void
+IMUITable::cancelJob() {
+    if (this->curJob) {
+        this->curJob->cancelled = true;
+        #if ORYOL_HAS_THREADS
+        std::unique_lock<std::mutex> lock(this->mutex);
+        const job* j = this->curJob;
+        this->cond.wait(lock, [j] { return bool(j->done); });
+        #endif
+        if (this->curJob->rebuild) {
+            this->rebuildRequested = true;
+        }
+        Memory::Delete(this->curJob);
+        this->curJob = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+IMUITable::runJob(job* j) {
+    // a cancelled job just returns, its result is dropped
+    const IMUITableSource* src = j->source;
+    const char* filter = j->target.filter;
+    const bool hasFilter = 0 != filter[0];
+    const int sortColumn = j->target.sortColumn;
+    const bool ascending = j->target.ascending;
+    const auto less = [src, sortColumn, ascending](int a, int b) {
+        const int c = src->CompareRows(a, b, sortColumn);
+        return ascending ? (c < 0) : (c > 0);
+    };
+    const auto sourceOrder = [](int a, int b) {
+        return a < b;
+    };
+
+    // rows from the current index array, already in display order
+    // (append jobs leave the index array alone)
+    std::vector<int> kept;
+    if (j->base && !j->append) {
+        if (j->testBase && hasFilter) {
+            kept.reserve(j->base->size());
+            for (size_t i = 0; i < j->base->size(); i++) {
+                if ((0 == (i % CancelCheckInterval)) && j->cancelled) {
+                    return;
+                }
+                const int row = (*j->base)[i];
+                if (src->MatchRow(row, filter)) {
+                    kept.push_back(row);
+                }
+            }
+        }
+        else {
+            kept = *j->base;
+        }
+        if (j->sortBase) {
+            const bool sorted = (sortColumn >= 0) ? sortRows(kept, less, j->cancelled) : sortRows(kept, sourceOrder, j->cancelled);
+            if (!sorted) {
+                return;
+            }
+        }
+    }
+
+    // new rows, or all rows for a rebuild
+    std::vector<int> added;
+    for (int row = j->firstRow; row < j->endRow; row++) {
+        if ((0 == (row % CancelCheckInterval)) && j->cancelled) {
+            return;
+        }
+        if (!hasFilter || src->MatchRow(row, filter)) {
+            added.push_back(row);
+        }
+    }
+    if ((sortColumn >= 0) && !sortRows(added, less, j->cancelled)) {
+        return;
+    }
+
+    // new rows have higher row indices, so in source order they're
+    // simply appended, otherwise they're merged by the sort order
+    if (j->append) {
+        // only find where the new rows go (behind equal rows, like a
+        // stable merge), mergeAppended() moves them into place
+        if ((sortColumn >= 0) && !added.empty()) {
+            const std::vector<int>& base = *j->base;
+            j->positions.resize(added.size());
+            auto pos = base.begin();
+            for (size_t i = 0; i < added.size(); i++) {
+                if ((0 == (i % CancelCheckInterval)) && j->cancelled) {
+                    return;
+                }
+                pos = std::upper_bound(pos, base.end(), added[i], less);
+                j->positions[i] = int(pos - base.begin());
+            }
+        }
+        j->result.swap(added);
+    }
+    else if (kept.empty()) {
+        j->result.swap(added);
+    }
+    else if (added.empty()) {
+        j->result.swap(kept);
+    }
+    else if (sortColumn >= 0) {
+        j->result.resize(kept.size() + added.size());
+        if (!mergeRows(kept.data(), kept.data() + kept.size(), added.data(), added.data() + added.size(), j->result.data(), less, j->cancelled)) {
+            return;
+        }
+    }
+    else {
+        j->result.swap(kept);
+        j->result.insert(j->result.end(), added.begin(), added.end());
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+IMUITable::mergeAppended(job* j) {
+    // the new rows come sorted from the thread, together with the index
+    // array position before which each of them goes, walking backwards
+    // each run of old rows moves up once, the rows in front of the
+    // first new row don't move at all
+    const std::vector<int>& added = j->result;
+    const size_t numOld = this->indices.size();
+    const size_t numAdded = added.size();
+    this->indices.resize(numOld + numAdded);
+    if (j->positions.empty()) {
+        std::copy(added.begin(), added.end(), this->indices.begin() + numOld);
+        return;
+    }
+    o_assert_dbg(j->positions.size() == numAdded);
+    size_t end = numOld;
+    for (size_t i = numAdded; i-- > 0; ) {
+        const size_t pos = size_t(j->positions[i]);
+        std::move_backward(this->indices.begin() + pos, this->indices.begin() + end, this->indices.begin() + end + i + 1);
+        this->indices[pos + i] = added[i];
+        end = pos;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+IMUITable::clearCells() {
+    this->cacheLines.Clear();
+    this->cacheIndex.Clear();
+}
+
+//------------------------------------------------------------------------------
+const char*
+IMUITable::cells(int row) {
+    const int lineSize = this->numColumns * MaxCellChars;
+    const int index = this->cacheIndex.FindIndex(row);
+    if (InvalidIndex != index) {
+        const int lineIndex = this->cacheIndex.ValueAtIndex(index);
+        this->cacheLines[lineIndex].lastUse = this->frameIndex;
+        return &this->cacheText[lineIndex * lineSize];
+    }
+
+    // use a free cache line, or the least recently used one
+    int lineIndex;
+    if (this->cacheLines.Size() < int(this->cacheText.size() / lineSize)) {
+        lineIndex = this->cacheLines.Size();
+        this->cacheLines.Add();
+    }
+    else {
+        lineIndex = 0;
+        for (int i = 1; i < this->cacheLines.Size(); i++) {
+            if (this->cacheLines[i].lastUse < this->cacheLines[lineIndex].lastUse) {
+                lineIndex = i;
+            }
+        }
+        this->cacheIndex.Erase(this->cacheLines[lineIndex].row);
+    }
+    cacheLine& line = this->cacheLines[lineIndex];
+    line.row = row;
+    line.lastUse = this->frameIndex;
+    this->cacheIndex.Add(row, lineIndex);
+    char* text = &this->cacheText[lineIndex * lineSize];
+    for (int column = 0; column < this->numColumns; column++) {
+        char* cell = text + column * MaxCellChars;
+        cell[0] = 0;
+        this->source->FormatCell(row, column, cell, MaxCellChars);
+        cell[MaxCellChars - 1] = 0;
+    }
+    return text;
+}
+
+//------------------------------------------------------------------------------
+void
+IMUITable::Draw(const char* id, const ImVec2& size) {
+    o_assert_dbg(this->IsValid());
+    this->update();
+    this->frameIndex++;
+    ImGui::PushID(id);
+
+    // filter field and row counts
+    if (ImGui::InputText("filter", this->filterBuf, sizeof(this->filterBuf))) {
+        this->SetFilter(this->filterBuf);
+    }
+    ImGui::SameLine();
+    ImGui::Text("%d of %d rows%s", this->NumDisplayRows(), this->source->NumRows(), this->IsBusy() ? " (updating)" : "");
+
+    // the header row sorts by a column (ascending, descending, off),
+    // the rows use the same column offsets as the header
+    float offsets[MaxColumns];
+    ImGui::Columns(this->numColumns, "header");
+    for (int column = 0; column < this->numColumns; column++) {
+        char label[MaxCellChars];
+        const char* arrow = "";
+        if (column == this->wantedView.sortColumn) {
+            arrow = this->wantedView.ascending ? " (asc)" : " (desc)";
+        }
+        snprintf(label, sizeof(label), "%s%s", this->source->ColumnName(column), arrow);
+        if (ImGui::Selectable(label)) {
+            if (column != this->wantedView.sortColumn) {
+                this->SortBy(column, true);
+            }
+            else if (this->wantedView.ascending) {
+                this->SortBy(column, false);
+            }
+            else {
+                this->SortBy(-1);
+            }
+        }
+        offsets[column] = ImGui::GetColumnOffset(column);
+        ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+    ImGui::Separator();
+
+    // only the visible rows are laid out, the cell cache keeps the
+    // formatted text of the visible rows and some scroll history
+    ImGui::BeginChild("rows", size);
+    ImGui::Columns(this->numColumns, "rows", false);
+    for (int column = 1; column < this->numColumns; column++) {
+        ImGui::SetColumnOffset(column, offsets[column]);
+    }
+    ImGuiListClipper clipper(this->NumDisplayRows());
+    while (clipper.Step()) {
+        const int numVisible = clipper.DisplayEnd - clipper.DisplayStart;
+        const int lineSize = this->numColumns * MaxCellChars;
+        const int wantedLines = 2 * numVisible + 16;
+        if (int(this->cacheText.size() / lineSize) < wantedLines) {
+            this->clearCells();
+            this->cacheText.resize(wantedLines * lineSize);
+        }
+        const int numRows = this->source->NumRows();
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+            // until a rebuild after Invalidate() is done, the index array
+            // may still contain rows which the source doesn't have anymore
+            const int row = this->indices[i];
+            if (row >= numRows) {
+                for (int column = 0; column < this->numColumns; column++) {
+                    ImGui::TextUnformatted("");
+                    ImGui::NextColumn();
+                }
+                continue;
+            }
+            const char* text = this->cells(row);
+            ImGui::PushID(row);
+            for (int column = 0; column < this->numColumns; column++) {
+                const char* cell = text + column * MaxCellChars;
+                if (0 == column) {
+                    if (ImGui::Selectable(cell, row == this->selectedRow, ImGuiSelectableFlags_SpanAllColumns)) {
+                        this->selectedRow = row;
+                    }
+                }
+                else {
+                    ImGui::TextUnformatted(cell);
+                }
+                ImGui::NextColumn();
+            }
+            ImGui::PopID();
+        }
+    }
+    ImGui::Columns(1);
+    ImGui::EndChild();
+    ImGui::PopID();
+}
+
+} // namespace Oryol
@@ -0,0 +1,195 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::IMUITableSource
+    @ingroup IMUI
+    @brief columnar data source of an IMUITable
+
+    The table only asks the source for the cells of visible rows, and
+    for row comparisons and filter tests while it sorts and filters.
+    Sorting and filtering run on a background thread, so FormatCell(),
+    CompareRows() and MatchRow() must be callable from another thread
+    while the app appends rows. Rows may only be appended while the
+    table is in use, call IMUITable::Invalidate() after other changes.
+*/
+#include "Core/Types.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Map.h"
+#include "imgui.h"
+#include <vector>
+#if ORYOL_HAS_THREADS
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace Oryol {
+
+class IMUITableSource {
+public:
+    /// destructor
+    virtual ~IMUITableSource() { };
+    /// get the number of rows
+    virtual int NumRows() const = 0;
+    /// get the number of columns
+    virtual int NumColumns() const = 0;
+    /// get the header text of a column
+    virtual const char* ColumnName(int column) const = 0;
+    /// write the zero-terminated text of a cell into buf
+    virtual void FormatCell(int row, int column, char* buf, int bufSize) const = 0;
+    /// compare two rows by a column (<0, 0, >0), default compares the cell texts
+    virtual int CompareRows(int rowA, int rowB, int column) const;
+    /// test if a row passes a lower-case filter, default is a case-insensitive substring test on all cells
+    virtual bool MatchRow(int row, const char* lowerCaseFilter) const;
+};
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::IMUITable
+    @ingroup IMUI
+    @brief virtualized table widget for millions of rows
+
+    Only the visible rows are laid out (through ImGuiListClipper), and
+    their formatted cells are cached across frames. The rows which
+    pass the filter are kept in display order in an index array, which
+    is rebuilt on a background thread when the filter or sort order
+    changes, or rows were appended to the source:
+
+    - a filter which contains the previous filter only re-tests the
+      rows which passed the previous filter
+    - appended rows are filtered and sorted on the thread, which also
+      finds their positions in the index array, Draw() then merges
+      them in place (only the rows behind the first new row move)
+    - a different sort column only re-sorts the filtered rows
+
+    The table keeps showing the previous index array until the new one
+    is done, so apart from merging appended rows the cost of a frame
+    only depends on the number of visible rows. Sorting checks for
+    cancellation every few thousand row comparisons, so a new filter
+    or Discard() doesn't wait for a complete sort. All updates run on
+    one worker thread per table, without thread support they run in
+    Draw().
+*/
+class IMUITable {
+public:
+    /// destructor
+    ~IMUITable();
+    /// setup with a data source (must outlive the table)
+    void Setup(const IMUITableSource* source);
+    /// discard the table, waits for a running update
+    void Discard();
+    /// return true if the table has been setup
+    bool IsValid() const;
+
+    /// draw the filter field, header and visible rows into the current window
+    void Draw(const char* id, const ImVec2& size=ImVec2(0, 0));
+    /// set the filter text (case-insensitive, empty shows all rows)
+    void SetFilter(const char* filter);
+    /// sort by a column, or -1 for source order
+    void SortBy(int column, bool ascending=true);
+    /// the source has changed other than by appending rows
+    void Invalidate();
+
+    /// return true while the index array is updated
+    bool IsBusy() const;
+    /// get number of rows which passed the filter (in the current index array)
+    int NumDisplayRows() const;
+    /// get the source row of a display row
+    int DisplayRow(int displayIndex) const;
+    /// get the selected source row (-1 if none)
+    int SelectedRow() const;
+
+    /// max number of columns
+    static const int MaxColumns = 16;
+    /// max length of a cell text (longer texts are cut off)
+    static const int MaxCellChars = 128;
+    /// max length of the filter text
+    static const int MaxFilterChars = 128;
+
+private:
+    /// filter and sort state of an index array
+    struct view {
+        char filter[MaxFilterChars] = { };
+        int sortColumn = -1;
+        bool ascending = true;
+    };
+    /// a background update of the index array
+    struct job {
+        const IMUITableSource* source = nullptr;
+        view target;
+        /// the job starts over from all rows (after Invalidate())
+        bool rebuild = false;
+        /// only new rows, result gets merged into the index array in place
+        bool append = false;
+        /// the current index array (read-only while the job runs)
+        const std::vector<int>* base = nullptr;
+        bool testBase = false;
+        bool sortBase = false;
+        /// the new rows to filter, sort and merge
+        int firstRow = 0;
+        int endRow = 0;
+        std::vector<int> result;
+        /// append jobs in sort order: index array position of each result row
+        std::vector<int> positions;
+        #if ORYOL_HAS_THREADS
+        std::atomic<bool> cancelled{false};
+        std::atomic<bool> done{false};
+        #else
+        bool cancelled = false;
+        bool done = false;
+        #endif
+    };
+    /// pick up a finished update and start the next one if needed
+    void update();
+    /// start an update from the current index array towards the wanted view
+    void startJob(bool rebuild);
+    /// wait for a running update and drop its result
+    void cancelJob();
+    /// filter, sort and merge rows (runs on the background thread)
+    static void runJob(job* j);
+    /// merge the rows of a finished append job into the index array
+    void mergeAppended(job* j);
+    #if ORYOL_HAS_THREADS
+    /// worker thread entry, runs one job after another
+    void workerLoop();
+    #endif
+    /// get the cached cells of a source row (MaxCellChars per column)
+    const char* cells(int row);
+    /// drop the cached cells
+    void clearCells();
+
+    const IMUITableSource* source = nullptr;
+    int numColumns = 0;
+    /// display index to source row, and the state it was built for
+    std::vector<int> indices;
+    view indicesView;
+    int numRowsIndexed = 0;
+    /// the state requested by the app or the UI
+    view wantedView;
+    bool rebuildRequested = false;
+    job* curJob = nullptr;
+    #if ORYOL_HAS_THREADS
+    /// the worker thread is started by the first update
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cond;
+    job* queuedJob = nullptr;
+    bool stopRequested = false;
+    #endif
+
+    /// formatted cells of recently visible rows
+    struct cacheLine {
+        int row = -1;
+        int lastUse = 0;
+    };
+    Array<cacheLine> cacheLines;
+    Map<int, int> cacheIndex;
+    std::vector<char> cacheText;
+    int frameIndex = 0;
+
+    char filterBuf[MaxFilterChars] = { };
+    int selectedRow = -1;
+};
+
+} // namespace Oryol
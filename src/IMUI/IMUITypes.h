@@ -0,0 +1,149 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::IMUIMemoryUsage
+    @ingroup IMUI
+    @brief memory usage of the IMUI module in bytes
+*/
+#include "Core/Types.h"
+#include "Core/Time/Duration.h"
+#include "Core/Time/TimePoint.h"
+
+namespace Oryol {
+
+class IMUIMemoryUsage {
+public:
+    /// CPU-side vertex and index staging buffers
+    int StagingBytes = 0;
+    /// GPU-side vertex and index stream buffers of all contexts, and GPU plot buffers
+    int StreamMeshBytes = 0;
+    /// font atlas and internal textures
+    int TextureBytes = 0;
+    /// font atlas texture alone (included in TextureBytes)
+    int FontAtlasBytes = 0;
+    /// image atlas pages (CPU-side copies and textures)
+    int ImageAtlasBytes = 0;
+    /// sum of all of the above
+    int TotalBytes() const {
+        return this->StagingBytes + this->StreamMeshBytes + this->TextureBytes + this->ImageAtlasBytes;
+    }
+};
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::IMUIFrameStats
+    @ingroup IMUI
+    @brief per-frame counters and timings of the IMUI render path
+
+    The counters are reset in IMUI::NewFrame() and filled in while
+    ImGui::Render() calls into the IMUI render callback.
+*/
+class IMUIFrameStats {
+public:
+    /// number of draw lists, vertices and indices rendered
+    int NumCmdLists = 0;
+    /// number of draw lists skipped because they don't fit into a stream mesh
+    int NumCmdListsDropped = 0;
+    int NumVertices = 0;
+    int NumIndices = 0;
+    /// number of stream chunks used
+    int NumChunks = 0;
+    /// number of ImDrawCmds rendered (without user callbacks)
+    int NumDrawCmds = 0;
+    /// number of Gfx calls issued by the render callback
+    int NumDraws = 0;
+    int NumApplyDrawState = 0;
+    int NumApplyUniformBlock = 0;
+    int NumApplyScissorRect = 0;
+    /// number of texture changes between draw calls
+    int NumTextureChanges = 0;
+    /// number of draw calls saved by merging adjacent draw commands
+    int NumDrawsSaved = 0;
+    /// number of scissor rect calls skipped because the rect didn't change
+    int NumScissorRectsSaved = 0;
+    /// number of texture switches avoided because images share an atlas page
+    int NumTextureSwitchesSaved = 0;
+    /// number of bytes copied into the staging buffers
+    int BytesCopied = 0;
+    /// number of bytes uploaded into stream meshes
+    int BytesUploaded = 0;
+    /// number of stream chunks uploaded directly from a draw list, without staging copy
+    int NumDirectUploads = 0;
+    /// number of GPU plots, their samples, and the bytes of sample data uploaded (included in BytesUploaded)
+    int NumPlots = 0;
+    int NumPlotSamples = 0;
+    int PlotBytes = 0;
+    /// number of input events applied in IMUI::NewFrame() and IMUI::LatchInput()
+    int NumInputEvents = 0;
+    /// number of input events left in the queue for the next frame (a key or button changed twice)
+    int NumInputEventsDeferred = 0;
+    /// number of input events dropped because the queue was full
+    int NumInputEventsDropped = 0;
+    /// max number of frames an applied input event waited in the queue (1: applied in the next frame)
+    int InputLatencyFrames = 0;
+    /// true if the upload was skipped because the geometry didn't change
+    bool UploadSkipped = false;
+    /// CPU time spent in IMUI::NewFrame()
+    Duration NewFrameTime;
+    /// CPU time spent in the render callback (includes RebaseTime)
+    Duration RenderTime;
+    /// CPU time spent rebasing indices
+    Duration RebaseTime;
+    /// CPU time spent queueing and uploading GPU plots
+    Duration PlotTime;
+    /// time from the oldest applied input event to the render callback
+    Duration InputLatency;
+};
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::IMUIFontAtlasInfo
+    @ingroup IMUI
+    @brief how the font atlas was created in IMUI::Setup()
+*/
+class IMUIFontAtlasInfo {
+public:
+    /// size of the font atlas in pixels
+    int Width = 0;
+    int Height = 0;
+    /// cache key of the font setup (see IMUISetup::FontCacheData), 0 if no font cache is used
+    uint64_t CacheKey = 0;
+    /// true if the atlas was restored from IMUISetup::FontCacheData
+    bool LoadedFromCache = false;
+    /// time spent baking or loading the atlas and creating the texture (with async baking until the fonts were ready)
+    Duration SetupTime;
+};
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::IMUIInputEvent
+    @ingroup IMUI
+    @brief a timestamped input event for IMUI::InjectInputEvent()
+
+    Queued input events are applied in order in IMUI::NewFrame(). If a
+    mouse button or key changes more than once before a frame, the
+    remaining events are applied in the next frames, so that ImGui sees
+    every press and release.
+*/
+class IMUIInputEvent {
+public:
+    enum Type {
+        InvalidType = 0,
+        MouseMove,          ///< X, Y: mouse position in pixels
+        MouseButtonDown,    ///< Code: mouse button (0: left, 1: right, 2: middle)
+        MouseButtonUp,
+        MouseWheel,         ///< X, Y: horizontal and vertical wheel delta (fractional for high-resolution wheels)
+        KeyDown,            ///< Code: Oryol Key::Code
+        KeyUp,
+        Char,               ///< CharCode: UTF-16 text character
+    };
+    Type EventType = InvalidType;
+    /// time of the event (Clock::Now() if not set)
+    TimePoint Time;
+    float X = 0.0f;
+    float Y = 0.0f;
+    int Code = 0;
+    wchar_t CharCode = 0;
+};
+
+} // namespace Oryol
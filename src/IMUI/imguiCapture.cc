@@ -0,0 +1,327 @@
+//------------------------------------------------------------------------------
+//  imguiCapture.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "imguiCapture.h"
+#include "imguiKernels.h"
+#include "Core/Assertion.h"
+#include "Core/Log.h"
+#include "Core/Memory/Memory.h"
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+imguiCapture::~imguiCapture() {
+    this->close();
+}
+
+//------------------------------------------------------------------------------
+void
+imguiCapture::close() {
+    if (this->file) {
+        fclose(this->file);
+        this->file = nullptr;
+    }
+    for (ImDrawList* list : this->drawLists) {
+        Memory::Delete(list);
+    }
+    this->drawLists.Clear();
+    this->prevVertexHashes.Clear();
+    this->prevIndexHashes.Clear();
+    this->drawData = ImDrawData();
+    this->fileSize = 0;
+    this->reading = false;
+    this->error = false;
+    this->numFrames = 0;
+}
+
+//------------------------------------------------------------------------------
+void
+imguiCapture::write(const void* data, int numBytes) {
+    if (!this->error && (numBytes > 0)) {
+        if (fwrite(data, 1, numBytes, this->file) != size_t(numBytes)) {
+            Log::Warn("imguiCapture: failed to write capture file!\n");
+            this->error = true;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiCapture::read(void* data, int numBytes) {
+    if (numBytes > 0) {
+        return fread(data, 1, numBytes, this->file) == size_t(numBytes);
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+int64_t
+imguiCapture::bytesLeft() const {
+    return this->fileSize - int64_t(ftell(this->file));
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiCapture::corrupt(const char* msg) {
+    Log::Warn("imguiCapture: %s\n", msg);
+    // the draw lists may be half-overwritten, so no later frame (which
+    // could be a delta of this one) is read
+    this->error = true;
+    this->drawData = ImDrawData();
+    return false;
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiCapture::BeginWrite(const char* path, bool delta_) {
+    o_assert_dbg(path && !this->file);
+    this->file = fopen(path, "wb");
+    if (!this->file) {
+        Log::Warn("imguiCapture: failed to open '%s' for writing!\n", path);
+        return false;
+    }
+    this->reading = false;
+    this->delta = delta_;
+    this->numFrames = 0;
+    fileHeader hdr;
+    hdr.magic = FileMagic;
+    hdr.version = Version;
+    hdr.vertexSize = sizeof(ImDrawVert);
+    hdr.indexSize = sizeof(ImDrawIdx);
+    this->write(&hdr, sizeof(hdr));
+    return !this->error;
+}
+
+//------------------------------------------------------------------------------
+void
+imguiCapture::WriteFrame(const ImDrawData* drawData_, const ImVec2& displaySize, ImTextureID fontTexId) {
+    o_assert_dbg(this->IsWriting());
+    frameHeader hdr;
+    hdr.magic = FrameMagic;
+    hdr.numCmdLists = drawData_->CmdListsCount;
+    hdr.displayWidth = displaySize.x;
+    hdr.displayHeight = displaySize.y;
+    hdr.fontTexId = uint64_t(uintptr_t(fontTexId));
+    this->write(&hdr, sizeof(hdr));
+
+    for (int cmdListIndex = 0; cmdListIndex < drawData_->CmdListsCount; cmdListIndex++) {
+        const ImDrawList* cmd_list = drawData_->CmdLists[cmdListIndex];
+        const int numVertices = cmd_list->VtxBuffer.size();
+        const int numIndices = cmd_list->IdxBuffer.size();
+
+        // the hashes include the size, so equal hashes mean equal buffers
+        listHeader listHdr;
+        listHdr.numVertices = numVertices;
+        listHdr.numIndices = numIndices;
+        listHdr.numCmds = cmd_list->CmdBuffer.size();
+        listHdr.flags = 0;
+        if (this->delta) {
+            const uint64_t vertexHash = imguiKernels::Hash(cmd_list->VtxBuffer.Data, numVertices * sizeof(ImDrawVert), 0);
+            const uint64_t indexHash = imguiKernels::Hash(cmd_list->IdxBuffer.Data, numIndices * sizeof(ImDrawIdx), 0);
+            if (cmdListIndex < this->prevVertexHashes.Size()) {
+                if (vertexHash == this->prevVertexHashes[cmdListIndex]) {
+                    listHdr.flags |= SameVertices;
+                }
+                if (indexHash == this->prevIndexHashes[cmdListIndex]) {
+                    listHdr.flags |= SameIndices;
+                }
+                this->prevVertexHashes[cmdListIndex] = vertexHash;
+                this->prevIndexHashes[cmdListIndex] = indexHash;
+            }
+            else {
+                this->prevVertexHashes.Add(vertexHash);
+                this->prevIndexHashes.Add(indexHash);
+            }
+        }
+        this->write(&listHdr, sizeof(listHdr));
+
+        for (const ImDrawCmd& cmd : cmd_list->CmdBuffer) {
+            cmdRecord rec;
+            rec.elemCount = cmd.ElemCount;
+            rec.isCallback = cmd.UserCallback ? 1 : 0;
+            rec.clipRect[0] = cmd.ClipRect.x;
+            rec.clipRect[1] = cmd.ClipRect.y;
+            rec.clipRect[2] = cmd.ClipRect.z;
+            rec.clipRect[3] = cmd.ClipRect.w;
+            rec.textureId = uint64_t(uintptr_t(cmd.TextureId));
+            this->write(&rec, sizeof(rec));
+        }
+        if (0 == (listHdr.flags & SameVertices)) {
+            this->write(cmd_list->VtxBuffer.Data, numVertices * sizeof(ImDrawVert));
+        }
+        if (0 == (listHdr.flags & SameIndices)) {
+            this->write(cmd_list->IdxBuffer.Data, numIndices * sizeof(ImDrawIdx));
+        }
+    }
+    this->numFrames++;
+}
+
+//------------------------------------------------------------------------------
+void
+imguiCapture::EndWrite() {
+    o_assert_dbg(this->IsWriting());
+    this->close();
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiCapture::IsWriting() const {
+    return this->file && !this->reading;
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiCapture::BeginRead(const char* path) {
+    o_assert_dbg(path && !this->file);
+    this->file = fopen(path, "rb");
+    if (!this->file) {
+        Log::Warn("imguiCapture: failed to open '%s' for reading!\n", path);
+        return false;
+    }
+    this->reading = true;
+    this->numFrames = 0;
+    fseek(this->file, 0, SEEK_END);
+    this->fileSize = int64_t(ftell(this->file));
+    fseek(this->file, 0, SEEK_SET);
+    fileHeader hdr;
+    if (!this->read(&hdr, sizeof(hdr)) || (hdr.magic != FileMagic) || (hdr.version != Version) ||
+        (hdr.vertexSize != sizeof(ImDrawVert)) || (hdr.indexSize != sizeof(ImDrawIdx))) {
+        Log::Warn("imguiCapture: '%s' is not a compatible capture file!\n", path);
+        this->close();
+        return false;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiCapture::ReadFrame(ImVec2& outDisplaySize, ImTextureID fontTexId) {
+    o_assert_dbg(this->IsReading());
+    if (this->error) {
+        return false;
+    }
+    if (0 == this->bytesLeft()) {
+        // regular end of file
+        return false;
+    }
+    frameHeader hdr;
+    if (!this->read(&hdr, sizeof(hdr))) {
+        return this->corrupt("truncated capture file!");
+    }
+    if ((hdr.magic != FrameMagic) || (hdr.numCmdLists < 0) || (hdr.numCmdLists > MaxCmdLists) ||
+        (int64_t(hdr.numCmdLists) * int64_t(sizeof(listHeader)) > this->bytesLeft())) {
+        return this->corrupt("corrupt frame in capture file!");
+    }
+    outDisplaySize = ImVec2(hdr.displayWidth, hdr.displayHeight);
+
+    // delta flags refer to the draw lists of the previous frame
+    const int numPrevCmdLists = this->drawData.CmdListsCount;
+    while (this->drawLists.Size() < hdr.numCmdLists) {
+        this->drawLists.Add(Memory::New<ImDrawList>(ImGui::GetDrawListSharedData()));
+    }
+    int64_t totalVertices = 0;
+    int64_t totalIndices = 0;
+    for (int cmdListIndex = 0; cmdListIndex < hdr.numCmdLists; cmdListIndex++) {
+        ImDrawList* cmd_list = this->drawLists[cmdListIndex];
+        listHeader listHdr;
+        if (!this->read(&listHdr, sizeof(listHdr))) {
+            return this->corrupt("truncated capture file!");
+        }
+        const bool sameVertices = 0 != (listHdr.flags & SameVertices);
+        const bool sameIndices = 0 != (listHdr.flags & SameIndices);
+        if ((listHdr.numVertices < 0) || (listHdr.numVertices > MaxListVertices) ||
+            (listHdr.numIndices < 0) || (listHdr.numIndices > MaxListIndices) ||
+            (listHdr.numCmds < 0) || (listHdr.numCmds > MaxListCmds) ||
+            (0 != (listHdr.flags & ~uint32_t(SameVertices|SameIndices)))) {
+            return this->corrupt("corrupt draw list in capture file!");
+        }
+        if ((sameVertices && ((cmdListIndex >= numPrevCmdLists) || (cmd_list->VtxBuffer.size() != listHdr.numVertices))) ||
+            (sameIndices && ((cmdListIndex >= numPrevCmdLists) || (cmd_list->IdxBuffer.size() != listHdr.numIndices)))) {
+            return this->corrupt("delta draw list without matching previous frame in capture file!");
+        }
+        const int64_t numBytes = int64_t(listHdr.numCmds) * int64_t(sizeof(cmdRecord)) +
+            (sameVertices ? 0 : int64_t(listHdr.numVertices) * int64_t(sizeof(ImDrawVert))) +
+            (sameIndices ? 0 : int64_t(listHdr.numIndices) * int64_t(sizeof(ImDrawIdx)));
+        if (numBytes > this->bytesLeft()) {
+            return this->corrupt("truncated capture file!");
+        }
+        cmd_list->CmdBuffer.resize(listHdr.numCmds);
+        int64_t numElements = 0;
+        for (ImDrawCmd& cmd : cmd_list->CmdBuffer) {
+            cmdRecord rec;
+            if (!this->read(&rec, sizeof(rec))) {
+                return this->corrupt("truncated capture file!");
+            }
+            cmd = ImDrawCmd();
+            cmd.ElemCount = rec.isCallback ? 0 : rec.elemCount;
+            cmd.ClipRect = ImVec4(rec.clipRect[0], rec.clipRect[1], rec.clipRect[2], rec.clipRect[3]);
+            cmd.TextureId = (rec.textureId == hdr.fontTexId) ? fontTexId : nullptr;
+            numElements += cmd.ElemCount;
+        }
+        if (numElements > listHdr.numIndices) {
+            return this->corrupt("draw commands exceed index buffer in capture file!");
+        }
+        // delta frames keep the buffers of the previous frame
+        if (!sameVertices) {
+            cmd_list->VtxBuffer.resize(listHdr.numVertices);
+            if (!this->read(cmd_list->VtxBuffer.Data, listHdr.numVertices * sizeof(ImDrawVert))) {
+                return this->corrupt("truncated capture file!");
+            }
+        }
+        if (!sameIndices) {
+            cmd_list->IdxBuffer.resize(listHdr.numIndices);
+            if (!this->read(cmd_list->IdxBuffer.Data, listHdr.numIndices * sizeof(ImDrawIdx))) {
+                return this->corrupt("truncated capture file!");
+            }
+        }
+        // kept indices are checked as well, the vertex count may have changed
+        const ImDrawIdx* indices = cmd_list->IdxBuffer.Data;
+        for (int i = 0; i < listHdr.numIndices; i++) {
+            if (int(indices[i]) >= listHdr.numVertices) {
+                return this->corrupt("index out of range in capture file!");
+            }
+        }
+        totalVertices += listHdr.numVertices;
+        totalIndices += listHdr.numIndices;
+    }
+    if ((totalVertices > 0x7FFFFFFF) || (totalIndices > 0x7FFFFFFF)) {
+        return this->corrupt("corrupt frame in capture file!");
+    }
+    this->drawData.Valid = true;
+    this->drawData.CmdLists = this->drawLists.Empty() ? nullptr : &this->drawLists[0];
+    this->drawData.CmdListsCount = hdr.numCmdLists;
+    this->drawData.TotalVtxCount = int(totalVertices);
+    this->drawData.TotalIdxCount = int(totalIndices);
+    this->numFrames++;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+ImDrawData*
+imguiCapture::DrawData() {
+    return &this->drawData;
+}
+
+//------------------------------------------------------------------------------
+void
+imguiCapture::EndRead() {
+    o_assert_dbg(this->IsReading());
+    this->close();
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiCapture::IsReading() const {
+    return this->file && this->reading;
+}
+
+//------------------------------------------------------------------------------
+int
+imguiCapture::NumFrames() const {
+    return this->numFrames;
+}
+
+} // namespace _priv
+} // namespace Oryol
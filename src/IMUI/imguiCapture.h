@@ -0,0 +1,126 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::imguiCapture
+    @brief write ImDrawData frames into a capture file and read them back
+
+    A capture file starts with a file header, followed by one record
+    per frame. A frame record holds the display size, the font atlas
+    ImTextureID, and per draw list the draw commands (element count,
+    clip rect, texture id) and the vertex and index buffers. With
+    delta compression, vertex and index buffers which are identical
+    to the same draw list of the previous frame are omitted.
+
+    User callbacks can't be replayed, they are read back as empty
+    draw commands. Texture ids other than the font atlas are read
+    back as 0 (which renders with the white placeholder texture).
+
+    Capture files are untrusted input: all counts are checked against
+    sanity limits and the remaining file size, delta flags against the
+    previous frame, and indices and element counts against the buffer
+    sizes. Reading stops at the first corrupt frame.
+*/
+#include "Core/Types.h"
+#include "Core/Containers/Array.h"
+#include "imgui.h"
+#include <cstdio>
+
+namespace Oryol {
+namespace _priv {
+
+class imguiCapture {
+public:
+    /// destructor
+    ~imguiCapture();
+
+    /// open a capture file for writing
+    bool BeginWrite(const char* path, bool delta);
+    /// append a frame to the capture file
+    void WriteFrame(const ImDrawData* drawData, const ImVec2& displaySize, ImTextureID fontTexId);
+    /// close the capture file
+    void EndWrite();
+    /// return true if a capture file is open for writing
+    bool IsWriting() const;
+
+    /// open a capture file for reading
+    bool BeginRead(const char* path);
+    /// read the next frame, returns false at the end of the file
+    bool ReadFrame(ImVec2& outDisplaySize, ImTextureID fontTexId);
+    /// get the draw data of the last frame read
+    ImDrawData* DrawData();
+    /// close the capture file
+    void EndRead();
+    /// return true if a capture file is open for reading
+    bool IsReading() const;
+
+    /// number of frames written or read so far
+    int NumFrames() const;
+
+private:
+    static const uint32_t FileMagic = 0x50434d49;     // 'IMCP'
+    static const uint32_t FrameMagic = 0x4d415246;    // 'FRAM'
+    static const uint32_t Version = 1;
+    /// draw list flags
+    enum {
+        SameVertices = (1<<0),
+        SameIndices = (1<<1),
+    };
+    /// sanity limits for reading, 16-bit indices can't address more than 64k vertices per draw list
+    static const int MaxCmdLists = 64 * 1024;
+    static const int MaxListVertices = sizeof(ImDrawIdx) == 2 ? 0x10000 : (1<<24);
+    static const int MaxListIndices = 1<<24;
+    static const int MaxListCmds = 1<<20;
+
+    struct fileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t vertexSize;
+        uint32_t indexSize;
+    };
+    struct frameHeader {
+        uint32_t magic;
+        int32_t numCmdLists;
+        float displayWidth;
+        float displayHeight;
+        uint64_t fontTexId;
+    };
+    struct listHeader {
+        int32_t numVertices;
+        int32_t numIndices;
+        int32_t numCmds;
+        uint32_t flags;
+    };
+    struct cmdRecord {
+        uint32_t elemCount;
+        uint32_t isCallback;
+        float clipRect[4];
+        uint64_t textureId;
+    };
+
+    /// write bytes, sets the error flag on failure
+    void write(const void* data, int numBytes);
+    /// read bytes, returns false on failure
+    bool read(void* data, int numBytes);
+    /// number of bytes left in the file which is read
+    int64_t bytesLeft() const;
+    /// stop reading a corrupt file, always returns false
+    bool corrupt(const char* msg);
+    /// close the file and free the replay draw lists
+    void close();
+
+    FILE* file = nullptr;
+    int64_t fileSize = 0;
+    bool reading = false;
+    bool delta = false;
+    bool error = false;
+    int numFrames = 0;
+    /// writer: hashes of the vertex and index buffers of the previous frame
+    Array<uint64_t> prevVertexHashes;
+    Array<uint64_t> prevIndexHashes;
+    /// reader: the draw lists of the current frame (persist for delta frames)
+    Array<ImDrawList*> drawLists;
+    ImDrawData drawData;
+};
+
+} // namespace _priv
+} // namespace Oryol
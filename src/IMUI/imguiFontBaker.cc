@@ -0,0 +1,395 @@
+//------------------------------------------------------------------------------
+//  imguiFontBaker.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "imguiFontBaker.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include "imgui_internal.h"
+#include <algorithm>
+
+// a private copy of stb_rect_pack and stb_truetype (ImGui's copy
+// allocates through ImGui::MemAlloc()), both compiled as static
+// functions so they don't clash with ImGui's copy
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable: 4244 4456 4457 4505 4701 4702)
+#elif defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-function"
+#elif defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wtype-limits"
+#endif
+namespace {
+void* bakerAlloc(size_t size) {
+    return Oryol::Memory::Alloc(int(size));
+}
+void bakerFree(void* ptr) {
+    if (ptr) {
+        Oryol::Memory::Free(ptr);
+    }
+}
+} // anonymous namespace
+#define STBRP_STATIC
+#define STBRP_ASSERT(x) o_assert_dbg(x)
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "stb_rect_pack.h"
+#define STBTT_malloc(x,u) ((void)(u), bakerAlloc(x))
+#define STBTT_free(x,u) ((void)(u), bakerFree(x))
+#define STBTT_assert(x) o_assert_dbg(x)
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "stb_truetype.h"
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#elif defined(__clang__)
+#pragma clang diagnostic pop
+#elif defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+/// the stb_truetype state of a bake, kept out of the header
+struct imguiFontBaker::bakeState {
+    /// per font config, allocated as zeroed memory
+    struct config {
+        stbtt_fontinfo fontInfo;
+        stbtt_pack_range* ranges;
+        int numRanges;
+        float ascent;
+        float descent;
+    };
+    config* configs = nullptr;
+    int numConfigs = 0;
+    stbtt_pack_range* ranges = nullptr;
+    stbtt_packedchar* packedChars = nullptr;
+};
+
+//------------------------------------------------------------------------------
+static void*
+allocZero(int numBytes) {
+    void* ptr = Memory::Alloc(numBytes > 0 ? numBytes : 1);
+    Memory::Clear(ptr, numBytes > 0 ? numBytes : 1);
+    return ptr;
+}
+
+//------------------------------------------------------------------------------
+imguiFontBaker::~imguiFontBaker() {
+    this->Discard();
+}
+
+//------------------------------------------------------------------------------
+void
+imguiFontBaker::Setup(ImFontAtlas* atlas_, int numTopBandConfigs_) {
+    o_assert_dbg(atlas_ && (atlas_->ConfigData.Size > 0));
+    o_assert_dbg((numTopBandConfigs_ >= 0) && (numTopBandConfigs_ <= atlas_->ConfigData.Size));
+    o_assert_dbg(!this->IsValid());
+    this->atlas = atlas_;
+    this->numTopBandConfigs = numTopBandConfigs_;
+    this->baked = false;
+
+    // the start of ImFontAtlas::Build(), the mouse cursor and white
+    // pixel rects are added here because that allocates
+    ImFontAtlasBuildRegisterDefaultCustomRects(atlas_);
+    atlas_->TexID = nullptr;
+    atlas_->TexWidth = atlas_->TexHeight = 0;
+    atlas_->TexUvScale = ImVec2(0.0f, 0.0f);
+    atlas_->TexUvWhitePixel = ImVec2(0.0f, 0.0f);
+    atlas_->ClearTexData();
+    for (ImFontConfig& cfg : atlas_->ConfigData) {
+        if (!cfg.GlyphRanges) {
+            cfg.GlyphRanges = atlas_->GetGlyphRangesDefault();
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiFontBaker::Bake() {
+    o_assert_dbg(this->atlas && !this->state && !this->baked);
+    const ImFontAtlas* atl = this->atlas;
+
+    // count glyphs and ranges
+    int numGlyphs = 0;
+    int numRanges = 0;
+    for (const ImFontConfig& cfg : atl->ConfigData) {
+        for (const ImWchar* range = cfg.GlyphRanges; range[0] && range[1]; range += 2, numRanges++) {
+            numGlyphs += (range[1] - range[0]) + 1;
+        }
+    }
+    this->state = Memory::New<bakeState>();
+    bakeState& s = *this->state;
+    s.numConfigs = atl->ConfigData.Size;
+    s.configs = (bakeState::config*) allocZero(s.numConfigs * sizeof(bakeState::config));
+    s.ranges = (stbtt_pack_range*) allocZero(numRanges * sizeof(stbtt_pack_range));
+    s.packedChars = (stbtt_packedchar*) allocZero(numGlyphs * sizeof(stbtt_packedchar));
+    for (int i = 0; i < s.numConfigs; i++) {
+        const ImFontConfig& cfg = atl->ConfigData[i];
+        const int fontOffset = stbtt_GetFontOffsetForIndex((const unsigned char*)cfg.FontData, cfg.FontNo);
+        if ((fontOffset < 0) || !stbtt_InitFont(&s.configs[i].fontInfo, (const unsigned char*)cfg.FontData, fontOffset)) {
+            return false;
+        }
+    }
+
+    // same width heuristic as ImFontAtlas::Build(), the height follows
+    // from packing into an (almost) infinitely tall texture
+    this->width = (atl->TexDesiredWidth > 0) ? atl->TexDesiredWidth :
+        (numGlyphs > 4000) ? 4096 : (numGlyphs > 2000) ? 2048 : (numGlyphs > 1000) ? 1024 : 512;
+    int texHeight = 0;
+    stbtt_pack_context spc = { };
+    if (!stbtt_PackBegin(&spc, nullptr, this->width, MaxTexHeight, 0, atl->TexGlyphPadding, nullptr)) {
+        return false;
+    }
+    stbtt_PackSetOversampling(&spc, 1, 1);
+
+    // the custom rects go first, into the upper-left corner
+    const int numCustomRects = atl->CustomRects.Size;
+    stbrp_rect* packRects = (stbrp_rect*) allocZero(numCustomRects * sizeof(stbrp_rect));
+    for (int i = 0; i < numCustomRects; i++) {
+        packRects[i].w = atl->CustomRects[i].Width;
+        packRects[i].h = atl->CustomRects[i].Height;
+    }
+    stbrp_pack_rects((stbrp_context*)spc.pack_info, packRects, numCustomRects);
+    this->customRects.Clear();
+    this->customRects.Reserve(numCustomRects);
+    for (int i = 0; i < numCustomRects; i++) {
+        customRectPos& pos = this->customRects.Add();
+        if (packRects[i].was_packed) {
+            pos.x = packRects[i].x;
+            pos.y = packRects[i].y;
+            texHeight = std::max(texHeight, packRects[i].y + packRects[i].h);
+        }
+    }
+    Memory::Free(packRects);
+
+    // first pass: pack the glyph rects of all fonts, the glyphs after
+    // the top band go into a fresh pack context which starts below it
+    stbrp_rect* rects = (stbrp_rect*) allocZero(numGlyphs * sizeof(stbrp_rect));
+    int rangeIndex = 0;
+    int glyphIndex = 0;
+    int offsetY = 0;
+    for (int i = 0; i < s.numConfigs; i++) {
+        const ImFontConfig& cfg = atl->ConfigData[i];
+        if ((i > 0) && (i == this->numTopBandConfigs)) {
+            offsetY = texHeight;
+            stbtt_PackEnd(&spc);
+            if (!stbtt_PackBegin(&spc, nullptr, this->width, MaxTexHeight - offsetY, 0, atl->TexGlyphPadding, nullptr)) {
+                Memory::Free(rects);
+                return false;
+            }
+        }
+        bakeState::config& c = s.configs[i];
+        int numFontGlyphs = 0;
+        c.ranges = s.ranges + rangeIndex;
+        for (const ImWchar* range = cfg.GlyphRanges; range[0] && range[1]; range += 2, c.numRanges++) {
+            stbtt_pack_range& packRange = c.ranges[c.numRanges];
+            packRange.font_size = cfg.SizePixels;
+            packRange.first_unicode_codepoint_in_range = range[0];
+            packRange.num_chars = (range[1] - range[0]) + 1;
+            packRange.chardata_for_range = s.packedChars + glyphIndex + numFontGlyphs;
+            numFontGlyphs += packRange.num_chars;
+        }
+        rangeIndex += c.numRanges;
+        stbrp_rect* fontRects = rects + glyphIndex;
+        stbtt_PackSetOversampling(&spc, cfg.OversampleH, cfg.OversampleV);
+        const int n = stbtt_PackFontRangesGatherRects(&spc, &c.fontInfo, c.ranges, c.numRanges, fontRects);
+        o_assert_dbg(n == numFontGlyphs);
+
+        // missing glyphs become zero-sized boxes, so that merged icon
+        // fonts don't get the fallback glyph
+        int rectIndex = 0;
+        for (int r = 0; r < c.numRanges; r++) {
+            for (int ch = 0; ch < c.ranges[r].num_chars; ch++, rectIndex++) {
+                if (0 == stbtt_FindGlyphIndex(&c.fontInfo, c.ranges[r].first_unicode_codepoint_in_range + ch)) {
+                    fontRects[rectIndex].w = fontRects[rectIndex].h = 0;
+                }
+            }
+        }
+        stbrp_pack_rects((stbrp_context*)spc.pack_info, fontRects, n);
+        for (int r = 0; r < n; r++) {
+            if ((0 == fontRects[r].w) && (0 == fontRects[r].h)) {
+                fontRects[r].was_packed = 0;
+            }
+            if (fontRects[r].was_packed) {
+                fontRects[r].y += offsetY;
+                texHeight = std::max(texHeight, fontRects[r].y + fontRects[r].h);
+            }
+        }
+        glyphIndex += numFontGlyphs;
+    }
+    o_assert_dbg((glyphIndex == numGlyphs) && (rangeIndex == numRanges));
+
+    // second pass: render the glyphs
+    this->height = 1;
+    while (this->height < texHeight) {
+        this->height *= 2;
+    }
+    this->pixels = (uint8_t*) allocZero(this->width * this->height);
+    spc.pixels = this->pixels;
+    spc.height = this->height;
+    this->glyphRects.Clear();
+    glyphIndex = 0;
+    for (int i = 0; i < s.numConfigs; i++) {
+        const ImFontConfig& cfg = atl->ConfigData[i];
+        bakeState::config& c = s.configs[i];
+        int numFontGlyphs = 0;
+        for (int r = 0; r < c.numRanges; r++) {
+            numFontGlyphs += c.ranges[r].num_chars;
+        }
+        stbrp_rect* fontRects = rects + glyphIndex;
+        glyphIndex += numFontGlyphs;
+        stbtt_PackSetOversampling(&spc, cfg.OversampleH, cfg.OversampleV);
+        stbtt_PackFontRangesRenderIntoRects(&spc, &c.fontInfo, c.ranges, c.numRanges, fontRects);
+        if (cfg.RasterizerMultiply != 1.0f) {
+            unsigned char multiplyTable[256];
+            ImFontAtlasBuildMultiplyCalcLookupTable(multiplyTable, cfg.RasterizerMultiply);
+            for (int r = 0; r < numFontGlyphs; r++) {
+                const stbrp_rect& rect = fontRects[r];
+                if (rect.was_packed) {
+                    ImFontAtlasBuildMultiplyRectAlpha8(multiplyTable, this->pixels, rect.x, rect.y, rect.w, rect.h, spc.stride_in_bytes);
+                }
+            }
+        }
+        // the packed chars have the rendered glyph bounds without padding
+        for (int r = 0; r < c.numRanges; r++) {
+            for (int ch = 0; ch < c.ranges[r].num_chars; ch++) {
+                const stbtt_packedchar& pc = c.ranges[r].chardata_for_range[ch];
+                if ((pc.x1 > pc.x0) && (pc.y1 > pc.y0)) {
+                    glyphRect& glyph = this->glyphRects.Add();
+                    glyph.config = i;
+                    glyph.x = pc.x0;
+                    glyph.y = pc.y0;
+                    glyph.w = pc.x1 - pc.x0;
+                    glyph.h = pc.y1 - pc.y0;
+                }
+            }
+        }
+        const float scale = stbtt_ScaleForPixelHeight(&c.fontInfo, cfg.SizePixels);
+        int ascent, descent, lineGap;
+        stbtt_GetFontVMetrics(&c.fontInfo, &ascent, &descent, &lineGap);
+        c.ascent = ascent * scale;
+        c.descent = descent * scale;
+    }
+    stbtt_PackEnd(&spc);
+    Memory::Free(rects);
+    this->baked = true;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+imguiFontBaker::Finish() {
+    o_assert_dbg(this->atlas);
+    if (!this->baked) {
+        // leave the atlas unbuilt, ImGui builds (and reports) it on first use
+        this->Discard();
+        return;
+    }
+    ImFontAtlas* atl = this->atlas;
+    const bakeState& s = *this->state;
+    atl->TexWidth = this->width;
+    atl->TexHeight = this->height;
+    atl->TexUvScale = ImVec2(1.0f / this->width, 1.0f / this->height);
+    atl->TexPixelsAlpha8 = (unsigned char*) ImGui::MemAlloc(this->width * this->height);
+    Memory::Copy(this->pixels, atl->TexPixelsAlpha8, this->width * this->height);
+    for (int i = 0; i < this->customRects.Size(); i++) {
+        if (this->customRects[i].x >= 0) {
+            atl->CustomRects[i].X = (unsigned short) this->customRects[i].x;
+            atl->CustomRects[i].Y = (unsigned short) this->customRects[i].y;
+        }
+    }
+
+    // third pass of ImFontAtlas::Build(): setup the fonts and add the glyphs
+    for (int i = 0; i < s.numConfigs; i++) {
+        ImFontConfig& cfg = atl->ConfigData[i];
+        const bakeState::config& c = s.configs[i];
+        // several configs may write into the same font (MergeMode)
+        ImFont* dstFont = cfg.DstFont;
+        if (cfg.MergeMode) {
+            dstFont->BuildLookupTable();
+        }
+        ImFontAtlasBuildSetupFont(atl, dstFont, &cfg, c.ascent, c.descent);
+        const float offX = cfg.GlyphOffset.x;
+        const float offY = cfg.GlyphOffset.y + (float)(int)(dstFont->Ascent + 0.5f);
+        for (int r = 0; r < c.numRanges; r++) {
+            const stbtt_pack_range& range = c.ranges[r];
+            for (int ch = 0; ch < range.num_chars; ch++) {
+                const stbtt_packedchar& pc = range.chardata_for_range[ch];
+                if (!pc.x0 && !pc.x1 && !pc.y0 && !pc.y1) {
+                    continue;
+                }
+                const int codepoint = range.first_unicode_codepoint_in_range + ch;
+                if (cfg.MergeMode && dstFont->FindGlyphNoFallback((ImWchar)codepoint)) {
+                    continue;
+                }
+                stbtt_aligned_quad q;
+                float x = 0.0f, y = 0.0f;
+                stbtt_GetPackedQuad(range.chardata_for_range, atl->TexWidth, atl->TexHeight, ch, &x, &y, &q, 0);
+                dstFont->AddGlyph((ImWchar)codepoint, q.x0 + offX, q.y0 + offY, q.x1 + offX, q.y1 + offY, q.s0, q.t0, q.s1, q.t1, pc.xadvance);
+            }
+        }
+    }
+    // renders the custom rects, builds the lookup tables
+    ImFontAtlasBuildFinish(atl);
+    this->Discard();
+}
+
+//------------------------------------------------------------------------------
+void
+imguiFontBaker::Discard() {
+    if (this->state) {
+        Memory::Free(this->state->configs);
+        Memory::Free(this->state->ranges);
+        Memory::Free(this->state->packedChars);
+        Memory::Delete(this->state);
+        this->state = nullptr;
+    }
+    if (this->pixels) {
+        Memory::Free(this->pixels);
+        this->pixels = nullptr;
+    }
+    this->glyphRects.Clear();
+    this->customRects.Clear();
+    this->width = 0;
+    this->height = 0;
+    this->baked = false;
+    this->atlas = nullptr;
+    this->numTopBandConfigs = 0;
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiFontBaker::IsValid() const {
+    return nullptr != this->atlas;
+}
+
+//------------------------------------------------------------------------------
+uint8_t*
+imguiFontBaker::Pixels() const {
+    return this->pixels;
+}
+
+//------------------------------------------------------------------------------
+int
+imguiFontBaker::Width() const {
+    return this->width;
+}
+
+//------------------------------------------------------------------------------
+int
+imguiFontBaker::Height() const {
+    return this->height;
+}
+
+//------------------------------------------------------------------------------
+const Array<imguiFontBaker::glyphRect>&
+imguiFontBaker::GlyphRects() const {
+    return this->glyphRects;
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,85 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::imguiFontBaker
+    @brief bake the glyphs of an ImFontAtlas without ImGui allocations
+
+    Splits ImFontAtlas::Build() into three steps. Setup() and Finish()
+    run on the main thread and do everything that allocates through
+    ImGui (default custom rects, glyph and lookup tables, the atlas
+    pixels). Bake() packs and rasterizes the glyphs with a private copy
+    of stb_truetype into memory owned by the baker. It never calls into
+    ImGui (ImGui::MemAlloc() writes to the current ImGui context) and
+    only reads the atlas, so it may run on a thread while the main
+    thread renders ImGui frames, as long as the atlas isn't used
+    anywhere else until Finish().
+
+    The baked atlas is the same as with ImFontAtlas::Build(), between
+    Bake() and Finish() the single-channel pixels and the glyph rects
+    may be post-processed (e.g. into a distance field). Optionally the
+    custom rects and the glyphs of the first font configs are packed
+    into a band at the top of the atlas, with all other glyphs below,
+    so that a shader can tell the two apart by the texture coordinate.
+*/
+#include "Core/Types.h"
+#include "Core/Containers/Array.h"
+#include "imgui.h"
+
+namespace Oryol {
+namespace _priv {
+
+class imguiFontBaker {
+public:
+    /// destructor
+    ~imguiFontBaker();
+
+    /// prepare baking the fonts added to an atlas (main thread), optionally with a top band for the first font configs
+    void Setup(ImFontAtlas* atlas, int numTopBandConfigs = 0);
+    /// pack and rasterize the glyphs (any thread), returns false if a font can't be read
+    bool Bake();
+    /// move the pixels and glyphs into the atlas and free the baker's memory (main thread)
+    void Finish();
+    /// free the baker's memory without finishing the atlas
+    void Discard();
+    /// return true between Setup() and Finish() or Discard()
+    bool IsValid() const;
+
+    /// a rasterized glyph in the atlas pixels (without padding)
+    struct glyphRect {
+        int config = 0;
+        int x = 0;
+        int y = 0;
+        int w = 0;
+        int h = 0;
+    };
+    /// the single-channel atlas pixels (valid after a successful Bake())
+    uint8_t* Pixels() const;
+    /// width and height of the atlas pixels
+    int Width() const;
+    int Height() const;
+    /// the glyph rects of all font configs
+    const Array<glyphRect>& GlyphRects() const;
+
+private:
+    /// same max atlas height as ImFontAtlas::Build()
+    static const int MaxTexHeight = 32 * 1024;
+
+    struct bakeState;
+    ImFontAtlas* atlas = nullptr;
+    int numTopBandConfigs = 0;
+    bakeState* state = nullptr;
+    bool baked = false;
+    uint8_t* pixels = nullptr;
+    int width = 0;
+    int height = 0;
+    Array<glyphRect> glyphRects;
+    /// packed position of the atlas' custom rects (x < 0: not packed)
+    struct customRectPos {
+        int x = -1;
+        int y = -1;
+    };
+    Array<customRectPos> customRects;
+};
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,246 @@
+//------------------------------------------------------------------------------
+//  imguiFontCache.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "imguiFontCache.h"
+#include "imguiKernels.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include <new>
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+template<class T> static uint64_t
+hashValue(const T& val, uint64_t hash) {
+    return imguiKernels::Hash(&val, sizeof(val), hash);
+}
+
+//------------------------------------------------------------------------------
+uint64_t
+imguiFontCache::ComputeKey(const IMUISetup& setup) {
+    uint64_t hash = imguiKernels::Hash(IMGUI_VERSION, sizeof(IMGUI_VERSION), Version);
+    hash = hashValue(sizeof(ImFontGlyph), hash);
+    hash = hashValue(setup.Alpha8FontAtlas, hash);
+    hash = hashValue(setup.SDFFonts, hash);
+    if (setup.SDFFonts) {
+        hash = hashValue(setup.SDFBakeHeight, hash);
+        hash = hashValue(setup.SDFSpread, hash);
+    }
+    hash = hashValue(setup.numFonts, hash);
+    for (int i = 0; i < setup.numFonts; i++) {
+        const auto& desc = setup.fonts[i];
+        hash = imguiKernels::Hash(desc.ttf_data, desc.ttf_size, hash);
+        hash = hashValue(desc.font_height, hash);
+        hash = hashValue(desc.compressed, hash);
+        if (desc.glyph_ranges) {
+            const ImWchar* range = desc.glyph_ranges;
+            while (range[0]) {
+                hash = imguiKernels::Hash(range, 2 * sizeof(ImWchar), hash);
+                range += 2;
+            }
+        }
+        // only the config members which affect the baked result
+        const ImFontConfig& cfg = *desc.font_config;
+        hash = hashValue(cfg.FontNo, hash);
+        hash = hashValue(cfg.OversampleH, hash);
+        hash = hashValue(cfg.OversampleV, hash);
+        hash = hashValue(cfg.PixelSnapH, hash);
+        hash = hashValue(cfg.GlyphExtraSpacing.x, hash);
+        hash = hashValue(cfg.GlyphExtraSpacing.y, hash);
+        hash = hashValue(cfg.GlyphOffset.x, hash);
+        hash = hashValue(cfg.GlyphOffset.y, hash);
+        hash = hashValue(cfg.MergeMode, hash);
+        hash = hashValue(cfg.RasterizerFlags, hash);
+        hash = hashValue(cfg.RasterizerMultiply, hash);
+    }
+    return hash;
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiFontCache::Load(ImFontAtlas* atlas, uint64_t key, const void* data, int size, int* outFontIndices, int numFontIndices) {
+    o_assert_dbg(atlas && atlas->Fonts.empty());
+    if ((nullptr == data) || (size < int(sizeof(header)))) {
+        return false;
+    }
+    const uint8_t* ptr = (const uint8_t*) data;
+    const uint8_t* end = ptr + size;
+    header hdr;
+    Memory::Copy(ptr, &hdr, sizeof(hdr));
+    ptr += sizeof(hdr);
+    if ((hdr.magic != Magic) || (hdr.version != Version) || (hdr.key != key) ||
+        (hdr.glyphSize != sizeof(ImFontGlyph)) || (hdr.numFontIndices != numFontIndices) ||
+        (hdr.numFonts <= 0) || (hdr.numCustomRects < 0) ||
+        (hdr.mouseCursorRect < -1) || (hdr.mouseCursorRect >= hdr.numCustomRects) ||
+        (hdr.texWidth <= 0) || (hdr.texHeight <= 0) ||
+        (hdr.texWidth > MaxTexSize) || (hdr.texHeight > MaxTexSize)) {
+        return false;
+    }
+
+    // validate the complete blob before touching the atlas
+    if (int64_t(end - ptr) < int64_t(numFontIndices) * int64_t(sizeof(int32_t))) {
+        return false;
+    }
+    for (int i = 0; i < numFontIndices; i++) {
+        int32_t fontIndex;
+        Memory::Copy(ptr + i * sizeof(int32_t), &fontIndex, sizeof(fontIndex));
+        if ((fontIndex < 0) || (fontIndex >= hdr.numFonts)) {
+            return false;
+        }
+    }
+    const uint8_t* fontPtr = ptr + numFontIndices * sizeof(int32_t);
+    for (int i = 0; i < hdr.numFonts; i++) {
+        if (int64_t(end - fontPtr) < int64_t(sizeof(fontHeader))) {
+            return false;
+        }
+        fontHeader fontHdr;
+        Memory::Copy(fontPtr, &fontHdr, sizeof(fontHdr));
+        fontPtr += sizeof(fontHdr);
+        if ((fontHdr.numGlyphs < 0) ||
+            (int64_t(end - fontPtr) < int64_t(fontHdr.numGlyphs) * int64_t(sizeof(ImFontGlyph)))) {
+            return false;
+        }
+        fontPtr += fontHdr.numGlyphs * sizeof(ImFontGlyph);
+    }
+    if (int64_t(end - fontPtr) < int64_t(hdr.numCustomRects) * int64_t(sizeof(customRect))) {
+        return false;
+    }
+    for (int i = 0; i < hdr.numCustomRects; i++) {
+        customRect rect;
+        Memory::Copy(fontPtr + i * sizeof(customRect), &rect, sizeof(rect));
+        if ((rect.fontIndex < -1) || (rect.fontIndex >= hdr.numFonts) ||
+            ((rect.x + rect.width) > hdr.texWidth) || ((rect.y + rect.height) > hdr.texHeight)) {
+            return false;
+        }
+    }
+    fontPtr += hdr.numCustomRects * sizeof(customRect);
+    const int numPixelBytes = hdr.texWidth * hdr.texHeight;
+    if (int64_t(end - fontPtr) != int64_t(numPixelBytes)) {
+        return false;
+    }
+
+    // font indices of the IMUISetup fonts (merged fonts share an ImFont)
+    for (int i = 0; i < numFontIndices; i++) {
+        int32_t fontIndex;
+        Memory::Copy(ptr, &fontIndex, sizeof(fontIndex));
+        ptr += sizeof(fontIndex);
+        outFontIndices[i] = fontIndex;
+    }
+
+    // fonts with their glyph tables
+    for (int i = 0; i < hdr.numFonts; i++) {
+        fontHeader fontHdr;
+        Memory::Copy(ptr, &fontHdr, sizeof(fontHdr));
+        ptr += sizeof(fontHdr);
+        ImFont* font = new (ImGui::MemAlloc(sizeof(ImFont))) ImFont();
+        font->ContainerAtlas = atlas;
+        font->FontSize = fontHdr.fontSize;
+        font->Scale = fontHdr.scale;
+        font->Ascent = fontHdr.ascent;
+        font->Descent = fontHdr.descent;
+        font->DisplayOffset = ImVec2(fontHdr.displayOffsetX, fontHdr.displayOffsetY);
+        font->Glyphs.resize(fontHdr.numGlyphs);
+        if (fontHdr.numGlyphs > 0) {
+            Memory::Copy(ptr, font->Glyphs.Data, fontHdr.numGlyphs * sizeof(ImFontGlyph));
+        }
+        ptr += fontHdr.numGlyphs * sizeof(ImFontGlyph);
+        font->SetFallbackChar(ImWchar(fontHdr.fallbackChar));
+        atlas->Fonts.push_back(font);
+    }
+
+    // custom rects, ImGui finds the mouse cursor shapes through CustomRectIds[0]
+    atlas->CustomRects.resize(hdr.numCustomRects);
+    for (int i = 0; i < hdr.numCustomRects; i++) {
+        customRect rect;
+        Memory::Copy(ptr, &rect, sizeof(rect));
+        ptr += sizeof(rect);
+        ImFontAtlas::CustomRect& dst = atlas->CustomRects[i];
+        dst.ID = rect.id;
+        dst.Width = rect.width;
+        dst.Height = rect.height;
+        dst.X = rect.x;
+        dst.Y = rect.y;
+        dst.GlyphAdvanceX = rect.glyphAdvanceX;
+        dst.GlyphOffset = ImVec2(rect.glyphOffsetX, rect.glyphOffsetY);
+        dst.Font = (rect.fontIndex >= 0) ? atlas->Fonts[rect.fontIndex] : nullptr;
+    }
+    atlas->CustomRectIds[0] = hdr.mouseCursorRect;
+
+    // the atlas pixels are owned (and freed) by the atlas, so they
+    // need to be copied out of the blob
+    atlas->TexWidth = hdr.texWidth;
+    atlas->TexHeight = hdr.texHeight;
+    atlas->TexUvWhitePixel = ImVec2(hdr.texUvWhitePixelX, hdr.texUvWhitePixelY);
+    atlas->TexPixelsAlpha8 = (unsigned char*) ImGui::MemAlloc(numPixelBytes);
+    Memory::Copy(ptr, atlas->TexPixelsAlpha8, numPixelBytes);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+imguiFontCache::Save(ImFontAtlas* atlas, uint64_t key, const int* fontIndices, int numFontIndices, Buffer& outData) {
+    o_assert_dbg(atlas && (atlas->Fonts.size() > 0));
+    unsigned char* pixels = nullptr;
+    int width = 0, height = 0;
+    atlas->GetTexDataAsAlpha8(&pixels, &width, &height);
+
+    header hdr;
+    hdr.magic = Magic;
+    hdr.version = Version;
+    hdr.key = key;
+    hdr.glyphSize = sizeof(ImFontGlyph);
+    hdr.texWidth = width;
+    hdr.texHeight = height;
+    hdr.texUvWhitePixelX = atlas->TexUvWhitePixel.x;
+    hdr.texUvWhitePixelY = atlas->TexUvWhitePixel.y;
+    hdr.numFonts = atlas->Fonts.size();
+    hdr.numFontIndices = numFontIndices;
+    hdr.numCustomRects = atlas->CustomRects.size();
+    hdr.mouseCursorRect = atlas->CustomRectIds[0];
+    outData.Clear();
+    outData.Add((const uint8_t*)&hdr, sizeof(hdr));
+    for (int i = 0; i < numFontIndices; i++) {
+        const int32_t fontIndex = fontIndices[i];
+        outData.Add((const uint8_t*)&fontIndex, sizeof(fontIndex));
+    }
+    for (const ImFont* font : atlas->Fonts) {
+        fontHeader fontHdr;
+        fontHdr.fontSize = font->FontSize;
+        fontHdr.scale = font->Scale;
+        fontHdr.ascent = font->Ascent;
+        fontHdr.descent = font->Descent;
+        fontHdr.displayOffsetX = font->DisplayOffset.x;
+        fontHdr.displayOffsetY = font->DisplayOffset.y;
+        fontHdr.fallbackChar = font->FallbackChar;
+        fontHdr.numGlyphs = font->Glyphs.size();
+        outData.Add((const uint8_t*)&fontHdr, sizeof(fontHdr));
+        if (fontHdr.numGlyphs > 0) {
+            outData.Add((const uint8_t*)font->Glyphs.Data, fontHdr.numGlyphs * sizeof(ImFontGlyph));
+        }
+    }
+    for (const ImFontAtlas::CustomRect& src : atlas->CustomRects) {
+        customRect rect;
+        rect.id = src.ID;
+        rect.width = src.Width;
+        rect.height = src.Height;
+        rect.x = src.X;
+        rect.y = src.Y;
+        rect.glyphAdvanceX = src.GlyphAdvanceX;
+        rect.glyphOffsetX = src.GlyphOffset.x;
+        rect.glyphOffsetY = src.GlyphOffset.y;
+        rect.fontIndex = -1;
+        for (int i = 0; i < atlas->Fonts.size(); i++) {
+            if (atlas->Fonts[i] == src.Font) {
+                rect.fontIndex = i;
+                break;
+            }
+        }
+        outData.Add((const uint8_t*)&rect, sizeof(rect));
+    }
+    outData.Add((const uint8_t*)pixels, width * height);
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,77 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::imguiFontCache
+    @brief save and restore a baked ImFontAtlas
+
+    The cache blob contains the baked single-channel atlas pixels, the
+    glyph and metrics tables of all fonts in the atlas and the atlas'
+    custom rects (the mouse cursor shapes). It is
+    tagged with a key computed from everything that goes into baking
+    (TTF data, sizes, glyph ranges, ImFontConfig, atlas options, ImGui
+    version), a blob with a different key is rejected.
+
+    The blob is read in place, so it may point directly into a
+    memory-mapped file.
+*/
+#include "Core/Types.h"
+#include "Core/Containers/Buffer.h"
+#include "imgui.h"
+#include "IMUI/IMUISetup.h"
+
+namespace Oryol {
+namespace _priv {
+
+class imguiFontCache {
+public:
+    /// compute the cache key for the fonts in an IMUISetup
+    static uint64_t ComputeKey(const IMUISetup& setup);
+    /// restore an empty atlas from a cache blob, returns false if the blob doesn't match
+    static bool Load(ImFontAtlas* atlas, uint64_t key, const void* data, int size, int* outFontIndices, int numFontIndices);
+    /// write a built atlas into a cache blob
+    static void Save(ImFontAtlas* atlas, uint64_t key, const int* fontIndices, int numFontIndices, Buffer& outData);
+
+private:
+    static const uint32_t Magic = 0x43464d49;    // 'IMFC'
+    static const uint32_t Version = 4;
+    static const int32_t MaxTexSize = 16 * 1024;
+
+    struct header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t key;
+        uint32_t glyphSize;
+        int32_t texWidth;
+        int32_t texHeight;
+        float texUvWhitePixelX;
+        float texUvWhitePixelY;
+        int32_t numFonts;
+        int32_t numFontIndices;
+        int32_t numCustomRects;
+        int32_t mouseCursorRect;
+    };
+    struct fontHeader {
+        float fontSize;
+        float scale;
+        float ascent;
+        float descent;
+        float displayOffsetX;
+        float displayOffsetY;
+        uint32_t fallbackChar;
+        int32_t numGlyphs;
+    };
+    struct customRect {
+        uint32_t id;
+        uint16_t width;
+        uint16_t height;
+        uint16_t x;
+        uint16_t y;
+        float glyphAdvanceX;
+        float glyphOffsetX;
+        float glyphOffsetY;
+        int32_t fontIndex;
+    };
+};
+
+} // namespace _priv
+} // namespace Oryol
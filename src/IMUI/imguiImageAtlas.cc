@@ -0,0 +1,176 @@
+//------------------------------------------------------------------------------
+//  imguiImageAtlas.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "imguiImageAtlas.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+imguiImageAtlas::~imguiImageAtlas() {
+    o_assert_dbg(this->pages.Empty());
+}
+
+//------------------------------------------------------------------------------
+void
+imguiImageAtlas::Setup(int pageSize_, int maxImageSize_, int maxPages_) {
+    o_assert_dbg(!this->IsValid());
+    o_assert_dbg((maxImageSize_ > 0) && ((maxImageSize_ + 2 * Border) <= pageSize_));
+    o_assert_dbg(maxPages_ > 0);
+    this->pageSize = pageSize_;
+    this->maxImageSize = maxImageSize_;
+    this->maxPages = maxPages_;
+}
+
+//------------------------------------------------------------------------------
+void
+imguiImageAtlas::Discard() {
+    for (auto& p : this->pages) {
+        if (p.texture.IsValid()) {
+            Gfx::DestroyResources(p.label);
+        }
+        Memory::Free(p.pixels);
+    }
+    this->pages.Clear();
+    this->pageSize = 0;
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiImageAtlas::IsValid() const {
+    return this->pageSize > 0;
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiImageAtlas::alloc(page& p, int width, int height, int& outX, int& outY) {
+    // the shelf state is only updated if the rect fits, a failed
+    // attempt must not start a new shelf in a page which could still
+    // take smaller images in the current one
+    int shelfX = p.shelfX;
+    int shelfY = p.shelfY;
+    int shelfHeight = p.shelfHeight;
+    // an empty page starts over
+    if (0 == p.numImages) {
+        shelfX = shelfY = shelfHeight = 0;
+    }
+    // start a new shelf if the current one is too narrow
+    if ((shelfX + width) > this->pageSize) {
+        shelfY += shelfHeight;
+        shelfX = 0;
+        shelfHeight = 0;
+    }
+    if ((shelfY + height) > this->pageSize) {
+        return false;
+    }
+    outX = shelfX;
+    outY = shelfY;
+    p.shelfX = shelfX + width;
+    p.shelfY = shelfY;
+    p.shelfHeight = height > shelfHeight ? height : shelfHeight;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+imguiImageAtlas::blit(page& p, int x, int y, const uint32_t* src, int width, int height) {
+    // copy the image rows, and repeat the first/last pixel of each
+    // row and the first/last row into the border
+    const int outerWidth = width + 2 * Border;
+    for (int row = -Border; row < (height + Border); row++) {
+        const int srcRow = row < 0 ? 0 : (row >= height ? height - 1 : row);
+        const uint32_t* srcPtr = src + srcRow * width;
+        uint32_t* dstPtr = p.pixels + (y + Border + row) * this->pageSize + x;
+        for (int i = 0; i < Border; i++) {
+            dstPtr[i] = srcPtr[0];
+            dstPtr[outerWidth - 1 - i] = srcPtr[width - 1];
+        }
+        Memory::Copy(srcPtr, dstPtr + Border, width * sizeof(uint32_t));
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiImageAtlas::Add(const void* rgba8Pixels, int width, int height, int& outPage, ImVec2& outUvOffset, ImVec2& outUvScale) {
+    o_assert_dbg(this->IsValid());
+    o_assert_dbg(rgba8Pixels && (width > 0) && (height > 0));
+    if ((width > this->maxImageSize) || (height > this->maxImageSize)) {
+        return false;
+    }
+    const int outerWidth = width + 2 * Border;
+    const int outerHeight = height + 2 * Border;
+    int pageIndex = 0;
+    int x = 0, y = 0;
+    for (; pageIndex < this->pages.Size(); pageIndex++) {
+        if (this->alloc(this->pages[pageIndex], outerWidth, outerHeight, x, y)) {
+            break;
+        }
+    }
+    if (pageIndex == this->pages.Size()) {
+        if (this->pages.Size() >= this->maxPages) {
+            return false;
+        }
+        page& newPage = this->pages.Add();
+        const int numBytes = this->pageSize * this->pageSize * sizeof(uint32_t);
+        newPage.pixels = (uint32_t*) Memory::Alloc(numBytes);
+        Memory::Clear(newPage.pixels, numBytes);
+        const bool fits = this->alloc(newPage, outerWidth, outerHeight, x, y);
+        o_assert_dbg(fits);
+        (void)fits;
+    }
+    page& p = this->pages[pageIndex];
+    this->blit(p, x, y, (const uint32_t*) rgba8Pixels, width, height);
+    p.numImages++;
+    p.dirty = true;
+
+    const float texelSize = 1.0f / float(this->pageSize);
+    outPage = pageIndex;
+    outUvOffset = ImVec2(float(x + Border) * texelSize, float(y + Border) * texelSize);
+    outUvScale = ImVec2(float(width) * texelSize, float(height) * texelSize);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+imguiImageAtlas::Remove(int pageIndex) {
+    page& p = this->pages[pageIndex];
+    o_assert_dbg(p.numImages > 0);
+    p.numImages--;
+}
+
+//------------------------------------------------------------------------------
+void
+imguiImageAtlas::Update() {
+    for (auto& p : this->pages) {
+        if (!p.dirty) {
+            continue;
+        }
+        if (p.texture.IsValid()) {
+            Gfx::DestroyResources(p.label);
+        }
+        const int numBytes = this->pageSize * this->pageSize * sizeof(uint32_t);
+        auto texSetup = TextureSetup::FromPixelData2D(this->pageSize, this->pageSize, 1, PixelFormat::RGBA8);
+        texSetup.Sampler.WrapU = TextureWrapMode::ClampToEdge;
+        texSetup.Sampler.WrapV = TextureWrapMode::ClampToEdge;
+        texSetup.Sampler.MinFilter = TextureFilterMode::Linear;
+        texSetup.Sampler.MagFilter = TextureFilterMode::Linear;
+        texSetup.ImageData.Sizes[0][0] = numBytes;
+        p.label = Gfx::PushResourceLabel();
+        p.texture = Gfx::CreateResource(texSetup, p.pixels, numBytes);
+        Gfx::PopResourceLabel();
+        p.dirty = false;
+    }
+}
+
+//------------------------------------------------------------------------------
+int
+imguiImageAtlas::Bytes() const {
+    // CPU-side copy plus texture
+    return this->pages.Size() * this->pageSize * this->pageSize * sizeof(uint32_t) * 2;
+}
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,74 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::imguiImageAtlas
+    @brief packs small RGBA8 images into shared atlas page textures
+
+    Images are packed into rows ('shelves') of a page with a 1-pixel
+    border which repeats the image's edge pixels, so that bilinear
+    filtering doesn't bleed in neighbouring images. Space is only
+    reclaimed when all images of a page have been removed.
+
+    Each page keeps a CPU-side copy of its pixels, changed pages are
+    re-created as a whole in Update() (Gfx textures can't be updated
+    partially). IMUI calls Update() once per frame, so all images added
+    during a frame are batched into one re-create per changed page, but
+    each such re-create uploads the complete page texture, no matter
+    how small the added images are.
+*/
+#include "Core/Types.h"
+#include "Core/Containers/Array.h"
+#include "Gfx/Gfx.h"
+#include "imgui.h"
+
+namespace Oryol {
+namespace _priv {
+
+class imguiImageAtlas {
+public:
+    /// destructor
+    ~imguiImageAtlas();
+    /// setup the atlas
+    void Setup(int pageSize, int maxImageSize, int maxPages);
+    /// discard the atlas and destroy the page textures
+    void Discard();
+    /// return true if the atlas has been setup
+    bool IsValid() const;
+    /// add an image, returns false if it's too big or all pages are full
+    bool Add(const void* rgba8Pixels, int width, int height, int& outPage, ImVec2& outUvOffset, ImVec2& outUvScale);
+    /// remove an image from a page
+    void Remove(int page);
+    /// re-create the textures of changed pages
+    void Update();
+    /// get the texture of a page
+    const Id& PageTexture(int page) const {
+        return this->pages[page].texture;
+    }
+    /// get CPU and GPU memory used by the atlas pages
+    int Bytes() const;
+
+private:
+    struct page {
+        ResourceLabel label;
+        Id texture;
+        uint32_t* pixels = nullptr;
+        int shelfX = 0;
+        int shelfY = 0;
+        int shelfHeight = 0;
+        int numImages = 0;
+        bool dirty = false;
+    };
+    /// try to allocate a rect in a page, returns false if the page is full
+    bool alloc(page& p, int width, int height, int& outX, int& outY);
+    /// copy an image with its repeated border into a page
+    void blit(page& p, int x, int y, const uint32_t* src, int width, int height);
+
+    static const int Border = 1;
+    int pageSize = 0;
+    int maxImageSize = 0;
+    int maxPages = 0;
+    Array<page> pages;
+};
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,117 @@
+//------------------------------------------------------------------------------
+//  imguiImagePool.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "imguiImagePool.h"
+#include "Core/Assertion.h"
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+void
+imguiImagePool::Setup(int initialCapacity) {
+    o_assert_dbg(initialCapacity > 0);
+    o_assert_dbg(this->slots.Empty());
+    this->slots.SetAllocStrategy(GrowChunk, GrowChunk);
+    this->freeSlots.SetAllocStrategy(GrowChunk, GrowChunk);
+    this->slots.Reserve(initialCapacity);
+    this->freeSlots.Reserve(initialCapacity);
+}
+
+//------------------------------------------------------------------------------
+void
+imguiImagePool::Discard() {
+    this->slots.Clear();
+    this->freeSlots.Clear();
+}
+
+//------------------------------------------------------------------------------
+ImTextureID
+imguiImagePool::Alloc() {
+    int index;
+    if (this->freeSlots.Empty()) {
+        o_assert(uintptr_t(this->slots.Size()) < IndexMask);
+        index = this->slots.Size();
+        this->slots.Add();
+    }
+    else {
+        index = this->freeSlots.PopBack();
+    }
+    slot& s = this->slots[index];
+    o_assert_dbg(!s.allocated);
+    s.allocated = true;
+    return ImTextureID((s.generation << IndexBits) | uintptr_t(index + 1));
+}
+
+//------------------------------------------------------------------------------
+void
+imguiImagePool::Free(ImTextureID img) {
+    o_assert_dbg(this->IsValid(img));
+    const int index = int(uintptr_t(img) & IndexMask) - 1;
+    slot& s = this->slots[index];
+    s.binding = entry();
+    s.allocated = false;
+    s.generation = (s.generation + 1) & GenerationMask;
+    if (0 == s.generation) {
+        s.generation = 1;
+    }
+    this->freeSlots.Add(index);
+}
+
+//------------------------------------------------------------------------------
+void
+imguiImagePool::Bind(ImTextureID img, const Id& texId) {
+    o_assert_dbg(this->IsValid(img));
+    const int index = int(uintptr_t(img) & IndexMask) - 1;
+    entry& binding = this->slots[index].binding;
+    binding.texture = texId;
+    binding.page = -1;
+}
+
+//------------------------------------------------------------------------------
+void
+imguiImagePool::BindAtlasRegion(ImTextureID img, int page, const ImVec2& uvOffset, const ImVec2& uvScale) {
+    o_assert_dbg(this->IsValid(img));
+    o_assert_dbg(page >= 0);
+    const int index = int(uintptr_t(img) & IndexMask) - 1;
+    entry& binding = this->slots[index].binding;
+    binding.texture.Invalidate();
+    binding.page = page;
+    binding.uvOffset = uvOffset;
+    binding.uvScale = uvScale;
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiImagePool::IsValid(ImTextureID img) const {
+    const uintptr_t h = uintptr_t(img);
+    const int index = int(h & IndexMask) - 1;
+    if ((index >= 0) && (index < this->slots.Size())) {
+        const slot& s = this->slots[index];
+        return s.allocated && (s.generation == (h >> IndexBits));
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiImagePool::IsBound(ImTextureID img) const {
+    const entry* binding = this->Lookup(img);
+    return binding && (binding->texture.IsValid() || (binding->page >= 0));
+}
+
+//------------------------------------------------------------------------------
+int
+imguiImagePool::NumAllocated() const {
+    return this->slots.Size() - this->freeSlots.Size();
+}
+
+//------------------------------------------------------------------------------
+int
+imguiImagePool::Capacity() const {
+    return this->slots.Size();
+}
+
+} // namespace _priv
+} // namespace Oryol
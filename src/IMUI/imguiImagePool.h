@@ -0,0 +1,85 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::imguiImagePool
+    @brief maps ImTextureIDs to Oryol texture ids
+
+    Image handles are slot indices with a generation counter in the
+    upper bits, a freed slot bumps its generation, so that handles
+    which are used after being freed are detected. The slot array
+    grows in chunks and freed slots are recycled, lookup is a single
+    array access plus a generation compare.
+*/
+#include "Core/Types.h"
+#include "Core/Containers/Array.h"
+#include "Resource/Id.h"
+#include "imgui.h"
+
+namespace Oryol {
+namespace _priv {
+
+class imguiImagePool {
+public:
+    /// setup the pool with an initial number of slots
+    void Setup(int initialCapacity);
+    /// discard the pool
+    void Discard();
+    /// allocate a new image handle
+    ImTextureID Alloc();
+    /// free an image handle, the slot will be reused with a new generation
+    void Free(ImTextureID img);
+    /// associate an image handle with a texture (may be called again to rebind)
+    void Bind(ImTextureID img, const Id& texId);
+    /// return true if the handle is alive (allocated and not freed)
+    bool IsValid(ImTextureID img) const;
+    /// return true if the handle is bound to a texture or atlas region
+    bool IsBound(ImTextureID img) const;
+    /// place an image handle in a region of an image atlas page
+    void BindAtlasRegion(ImTextureID img, int page, const ImVec2& uvOffset, const ImVec2& uvScale);
+    /// what an image handle is bound to
+    struct entry {
+        /// the bound texture (invalid if unbound or in an atlas page)
+        Id texture;
+        /// image atlas page index, or -1
+        int page = -1;
+        /// uv = uvOffset + uv * uvScale inside the atlas page
+        ImVec2 uvOffset;
+        ImVec2 uvScale;
+    };
+    /// get the binding of a handle, nullptr if the handle is stale
+    const entry* Lookup(ImTextureID img) const {
+        const uintptr_t h = uintptr_t(img);
+        const int index = int(h & IndexMask) - 1;
+        if ((index >= 0) && (index < this->slots.Size())) {
+            const slot& s = this->slots[index];
+            if (s.generation == (h >> IndexBits)) {
+                return &s.binding;
+            }
+        }
+        return nullptr;
+    }
+    /// number of allocated handles
+    int NumAllocated() const;
+    /// number of slots (allocated and free)
+    int Capacity() const;
+
+private:
+    /// the lower bits of a handle are the slot index + 1 (so that a
+    /// handle is never null), the upper bits the slot's generation,
+    /// this also fits into a 32-bit ImTextureID
+    static const int IndexBits = 20;
+    static const uintptr_t IndexMask = (uintptr_t(1) << IndexBits) - 1;
+    static const uintptr_t GenerationMask = (uintptr_t(1) << (32 - IndexBits)) - 1;
+    static const int GrowChunk = 256;
+
+    struct slot {
+        entry binding;
+        uintptr_t generation = 1;
+        bool allocated = false;
+    };
+    Array<slot> slots;
+    Array<int> freeSlots;
+};
+
+} // namespace _priv
+} // namespace Oryol
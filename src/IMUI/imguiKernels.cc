@@ -0,0 +1,213 @@
+//------------------------------------------------------------------------------
+//  imguiKernels.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "imguiKernels.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+
+#if defined(__AVX2__)
+#define ORYOL_IMUI_AVX2 (1)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define ORYOL_IMUI_SSE2 (1)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define ORYOL_IMUI_NEON (1)
+#include <arm_neon.h>
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+const char*
+imguiKernels::SimdName() {
+    #if ORYOL_IMUI_AVX2
+    return "avx2";
+    #elif ORYOL_IMUI_SSE2
+    return "sse2";
+    #elif ORYOL_IMUI_NEON
+    return "neon";
+    #else
+    return "scalar";
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+imguiKernels::RebaseIndices(uint16_t* dst, const uint16_t* src, int num, uint16_t baseVertexIndex) {
+    o_assert_dbg(dst && src && (num >= 0));
+    if (0 == baseVertexIndex) {
+        Memory::Copy(src, dst, num * sizeof(uint16_t));
+        return;
+    }
+    int i = 0;
+    #if ORYOL_IMUI_AVX2
+    const __m256i base = _mm256_set1_epi16((short)baseVertexIndex);
+    for (; (i + 16) <= num; i += 16) {
+        __m256i idx = _mm256_loadu_si256((const __m256i*)(src + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_add_epi16(idx, base));
+    }
+    #elif ORYOL_IMUI_SSE2
+    const __m128i base = _mm_set1_epi16((short)baseVertexIndex);
+    for (; (i + 16) <= num; i += 16) {
+        __m128i idx0 = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i idx1 = _mm_loadu_si128((const __m128i*)(src + i + 8));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_add_epi16(idx0, base));
+        _mm_storeu_si128((__m128i*)(dst + i + 8), _mm_add_epi16(idx1, base));
+    }
+    #elif ORYOL_IMUI_NEON
+    const uint16x8_t base = vdupq_n_u16(baseVertexIndex);
+    for (; (i + 16) <= num; i += 16) {
+        uint16x8_t idx0 = vld1q_u16(src + i);
+        uint16x8_t idx1 = vld1q_u16(src + i + 8);
+        vst1q_u16(dst + i, vaddq_u16(idx0, base));
+        vst1q_u16(dst + i + 8, vaddq_u16(idx1, base));
+    }
+    #endif
+    for (; i < num; i++) {
+        dst[i] = src[i] + baseVertexIndex;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+imguiKernels::RebaseIndices(uint32_t* dst, const uint32_t* src, int num, uint32_t baseVertexIndex) {
+    o_assert_dbg(dst && src && (num >= 0));
+    if (0 == baseVertexIndex) {
+        Memory::Copy(src, dst, num * sizeof(uint32_t));
+        return;
+    }
+    int i = 0;
+    #if ORYOL_IMUI_AVX2
+    const __m256i base = _mm256_set1_epi32((int)baseVertexIndex);
+    for (; (i + 8) <= num; i += 8) {
+        __m256i idx = _mm256_loadu_si256((const __m256i*)(src + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_add_epi32(idx, base));
+    }
+    #elif ORYOL_IMUI_SSE2
+    const __m128i base = _mm_set1_epi32((int)baseVertexIndex);
+    for (; (i + 8) <= num; i += 8) {
+        __m128i idx0 = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i idx1 = _mm_loadu_si128((const __m128i*)(src + i + 4));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_add_epi32(idx0, base));
+        _mm_storeu_si128((__m128i*)(dst + i + 4), _mm_add_epi32(idx1, base));
+    }
+    #elif ORYOL_IMUI_NEON
+    const uint32x4_t base = vdupq_n_u32(baseVertexIndex);
+    for (; (i + 8) <= num; i += 8) {
+        uint32x4_t idx0 = vld1q_u32(src + i);
+        uint32x4_t idx1 = vld1q_u32(src + i + 4);
+        vst1q_u32(dst + i, vaddq_u32(idx0, base));
+        vst1q_u32(dst + i + 4, vaddq_u32(idx1, base));
+    }
+    #endif
+    for (; i < num; i++) {
+        dst[i] = src[i] + baseVertexIndex;
+    }
+}
+
+//------------------------------------------------------------------------------
+static inline int16_t
+quantize(float val) {
+    // round to nearest and saturate
+    const float rounded = val < 0.0f ? val - 0.5f : val + 0.5f;
+    if (rounded >= 32767.0f) {
+        return 32767;
+    }
+    else if (rounded <= -32768.0f) {
+        return -32768;
+    }
+    return int16_t(rounded);
+}
+
+//------------------------------------------------------------------------------
+void
+imguiKernels::QuantizeVertices(imguiCompactVertex* dst, const ImDrawVert* src, int num, float posScale) {
+    static_assert(sizeof(imguiCompactVertex) == 12, "imguiCompactVertex size mismatch");
+    static_assert(sizeof(ImDrawVert) == 20, "QuantizeVertices() expects the default ImDrawVert layout");
+    o_assert_dbg(dst && src && (num >= 0));
+    const float uvScale = 32767.0f;
+    int i = 0;
+    #if ORYOL_IMUI_AVX2 || ORYOL_IMUI_SSE2
+    // pos and uv of 2 vertices are scaled, converted to int32 and
+    // packed with signed saturation into 8 int16 in one go, rounding
+    // is half away from zero like quantize() (+-0.5 and truncate,
+    // _mm_cvtps_epi32 would round half to even)
+    const __m128 scale = _mm_setr_ps(posScale, posScale, uvScale, uvScale);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    for (; (i + 2) <= num; i += 2) {
+        __m128 v0 = _mm_mul_ps(_mm_loadu_ps(&src[i].pos.x), scale);
+        __m128 v1 = _mm_mul_ps(_mm_loadu_ps(&src[i + 1].pos.x), scale);
+        v0 = _mm_add_ps(v0, _mm_or_ps(_mm_and_ps(v0, signMask), half));
+        v1 = _mm_add_ps(v1, _mm_or_ps(_mm_and_ps(v1, signMask), half));
+        __m128i i0 = _mm_cvttps_epi32(v0);
+        __m128i i1 = _mm_cvttps_epi32(v1);
+        __m128i packed = _mm_packs_epi32(i0, i1);
+        _mm_storel_epi64((__m128i*)&dst[i].x, packed);
+        _mm_storel_epi64((__m128i*)&dst[i + 1].x, _mm_unpackhi_epi64(packed, packed));
+        dst[i].color = src[i].col;
+        dst[i + 1].color = src[i + 1].col;
+    }
+    #elif ORYOL_IMUI_NEON
+    const float32x4_t scale = { posScale, posScale, uvScale, uvScale };
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t posHalf = vdupq_n_f32(0.5f);
+    const float32x4_t negHalf = vdupq_n_f32(-0.5f);
+    for (; (i + 2) <= num; i += 2) {
+        float32x4_t v0 = vmulq_f32(vld1q_f32(&src[i].pos.x), scale);
+        float32x4_t v1 = vmulq_f32(vld1q_f32(&src[i + 1].pos.x), scale);
+        v0 = vaddq_f32(v0, vbslq_f32(vcltq_f32(v0, zero), negHalf, posHalf));
+        v1 = vaddq_f32(v1, vbslq_f32(vcltq_f32(v1, zero), negHalf, posHalf));
+        vst1_s16(&dst[i].x, vqmovn_s32(vcvtq_s32_f32(v0)));
+        vst1_s16(&dst[i + 1].x, vqmovn_s32(vcvtq_s32_f32(v1)));
+        dst[i].color = src[i].col;
+        dst[i + 1].color = src[i + 1].col;
+    }
+    #endif
+    for (; i < num; i++) {
+        dst[i].x = quantize(src[i].pos.x * posScale);
+        dst[i].y = quantize(src[i].pos.y * posScale);
+        dst[i].u = quantize(src[i].uv.x * uvScale);
+        dst[i].v = quantize(src[i].uv.y * uvScale);
+        dst[i].color = src[i].col;
+    }
+}
+
+//------------------------------------------------------------------------------
+uint64_t
+imguiKernels::Hash(const void* data, int numBytes, uint64_t seed) {
+    o_assert_dbg(data || (0 == numBytes));
+    const uint64_t m = 0xc6a4a7935bd1e995ULL;
+    const int r = 47;
+    uint64_t h = seed ^ (uint64_t(numBytes) * m);
+    const uint8_t* ptr = (const uint8_t*) data;
+    const uint8_t* end = ptr + (numBytes & ~7);
+    for (; ptr != end; ptr += 8) {
+        uint64_t k;
+        Memory::Copy(ptr, &k, sizeof(k));
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+    const int rest = numBytes & 7;
+    if (rest > 0) {
+        uint64_t k = 0;
+        for (int i = rest - 1; i >= 0; i--) {
+            k = (k << 8) | ptr[i];
+        }
+        h ^= k;
+        h *= m;
+    }
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+}
+
+} // namespace _priv
+} // namespace Oryol
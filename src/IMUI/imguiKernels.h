@@ -0,0 +1,38 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::imguiKernels
+    @brief inner-loop helper functions for the imgui render path
+
+    The SIMD flavour (AVX2, SSE2, NEON or plain scalar code) is
+    selected at compile time from the target architecture defines.
+*/
+#include "Core/Types.h"
+#include "imgui.h"
+
+namespace Oryol {
+namespace _priv {
+
+/// compact 12-byte vertex: fixed-point position, normalized 16-bit uv, color
+struct imguiCompactVertex {
+    int16_t x, y;
+    int16_t u, v;
+    uint32_t color;
+};
+
+class imguiKernels {
+public:
+    /// copy 16-bit indices from src to dst and add a base vertex index
+    static void RebaseIndices(uint16_t* dst, const uint16_t* src, int num, uint16_t baseVertexIndex);
+    /// copy 32-bit indices from src to dst and add a base vertex index
+    static void RebaseIndices(uint32_t* dst, const uint32_t* src, int num, uint32_t baseVertexIndex);
+    /// convert ImDrawVerts to compact vertices (position * posScale, uv * 32767, both saturated to int16)
+    static void QuantizeVertices(imguiCompactVertex* dst, const ImDrawVert* src, int num, float posScale);
+    /// compute a fast 64-bit hash over a memory range (MurmurHash64A)
+    static uint64_t Hash(const void* data, int numBytes, uint64_t seed);
+    /// get the name of the compiled-in SIMD flavour
+    static const char* SimdName();
+};
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,227 @@
+//------------------------------------------------------------------------------
+//  imguiPlotRenderer.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "imguiPlotRenderer.h"
+#include "Core/Assertion.h"
+#include "IMUIShaders.h"
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include <algorithm>
+#include <cfloat>
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+VertexLayout
+imguiPlotRenderer::InstanceLayout() {
+    VertexLayout layout;
+    layout.EnableInstancing();
+    layout.Add(VertexAttr::Instance0, VertexFormat::Float3);
+    o_assert_dbg(layout.ByteSize() == sizeof(sample));
+    return layout;
+}
+
+//------------------------------------------------------------------------------
+VertexLayout
+imguiPlotRenderer::QuadLayout() {
+    VertexLayout layout;
+    layout.Add(VertexAttr::Position, VertexFormat::Float2);
+    return layout;
+}
+
+//------------------------------------------------------------------------------
+Id
+imguiPlotRenderer::CreateQuadMesh() {
+    static const struct {
+        float vertices[4][2];
+        uint16_t indices[6];
+    } data = {
+        { { 0.0f, -1.0f }, { 1.0f, -1.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } },
+        { 0, 1, 2, 0, 2, 3 }
+    };
+    auto meshSetup = MeshSetup::FromData();
+    meshSetup.NumVertices = 4;
+    meshSetup.NumIndices = 6;
+    meshSetup.IndicesType = IndexType::Index16;
+    meshSetup.Layout = QuadLayout();
+    meshSetup.AddPrimitiveGroup(PrimitiveGroup(0, 6));
+    meshSetup.VertexDataOffset = 0;
+    meshSetup.IndexDataOffset = sizeof(data.vertices);
+    return Gfx::CreateResource(meshSetup, &data, sizeof(data));
+}
+
+//------------------------------------------------------------------------------
+int
+imguiPlotRenderer::Add(plotType type, const float* values, int numValues, float scaleMin, float scaleMax, const ImVec4& rect, const ImVec4& color) {
+    o_assert_dbg(values && (numValues > 0));
+
+    // same auto-scaling rules as ImGui::PlotLines()
+    if ((scaleMin == FLT_MAX) || (scaleMax == FLT_MAX)) {
+        float minVal = FLT_MAX;
+        float maxVal = -FLT_MAX;
+        for (int i = 0; i < numValues; i++) {
+            minVal = std::min(minVal, values[i]);
+            maxVal = std::max(maxVal, values[i]);
+        }
+        if (scaleMin == FLT_MAX) {
+            scaleMin = minVal;
+        }
+        if (scaleMax == FLT_MAX) {
+            scaleMax = maxVal;
+        }
+    }
+
+    // a line segment needs the next value as well, a bar only its own
+    plot& p = this->plots.Add();
+    p.type = type;
+    p.firstSample = this->samples.Size() / sizeof(sample);
+    p.numSamples = (Lines == type) ? (numValues - 1) : numValues;
+    p.numValues = numValues;
+    p.scaleMin = scaleMin;
+    p.scaleMax = scaleMax;
+    p.rect = rect;
+    p.color = color;
+    sample* dst = (sample*) this->samples.Add(p.numSamples * sizeof(sample));
+    for (int i = 0; i < p.numSamples; i++) {
+        dst[i].index = float(i);
+        dst[i].value = values[i];
+        dst[i].nextValue = (Lines == type) ? values[i + 1] : 0.0f;
+    }
+    return this->plots.Size() - 1;
+}
+
+//------------------------------------------------------------------------------
+int
+imguiPlotRenderer::Upload() {
+    int numBytes = 0;
+    for (int plotIndex = 0; plotIndex < this->plots.Size(); plotIndex++) {
+        const plot& p = this->plots[plotIndex];
+        if (plotIndex == this->meshes.Size()) {
+            this->meshes.Add();
+        }
+        instanceMesh& im = this->meshes[plotIndex];
+        if (p.numSamples > im.capacity) {
+            if (im.mesh.IsValid()) {
+                Gfx::DestroyResources(im.label);
+            }
+            int capacity = MinInstanceCapacity;
+            while (capacity < p.numSamples) {
+                capacity *= 2;
+            }
+            MeshSetup meshSetup = MeshSetup::Empty(capacity, Usage::Stream);
+            meshSetup.Layout = InstanceLayout();
+            im.label = Gfx::PushResourceLabel();
+            im.mesh = Gfx::CreateResource(meshSetup);
+            Gfx::PopResourceLabel();
+            im.capacity = capacity;
+        }
+        if (p.numSamples > 0) {
+            const int plotBytes = p.numSamples * sizeof(sample);
+            Gfx::UpdateVertices(im.mesh, this->samples.Data() + p.firstSample * sizeof(sample), plotBytes);
+            numBytes += plotBytes;
+        }
+    }
+    return numBytes;
+}
+
+//------------------------------------------------------------------------------
+void
+imguiPlotRenderer::Draw(int plotIndex, const Id& quadMesh, const Id& pipeline, const ImVec4& clipRect) const {
+    const plot& p = this->plots[plotIndex];
+    if (0 == p.numSamples) {
+        return;
+    }
+
+    // draw only inside the plot area and the ImGui clip rect
+    const ImGuiIO& io = ImGui::GetIO();
+    const float x0 = std::max(clipRect.x, p.rect.x);
+    const float y0 = std::max(clipRect.y, p.rect.y);
+    const float x1 = std::min(clipRect.z, p.rect.z);
+    const float y1 = std::min(clipRect.w, p.rect.w);
+    if ((x1 <= x0) || (y1 <= y0)) {
+        return;
+    }
+
+    DrawState drawState;
+    drawState.Pipeline = pipeline;
+    drawState.Mesh[0] = quadMesh;
+    drawState.Mesh[1] = this->meshes[plotIndex].mesh;
+    Gfx::ApplyDrawState(drawState);
+
+    // scale.x: value at the bottom, scale.y: 1/value range,
+    // scale.z: width of a segment or bar in normalized plot width,
+    // scale.w: half line width in pixels, or the zero line of bars
+    // in normalized plot height (0 is the bottom)
+    const float range = p.scaleMax - p.scaleMin;
+    glm::vec4 scale;
+    scale.x = p.scaleMin;
+    scale.y = (range != 0.0f) ? (1.0f / range) : 0.0f;
+    if (Lines == p.type) {
+        scale.z = 1.0f / float(p.numValues - 1);
+        scale.w = 0.5f;
+        IMUIPlotLineShader::vsParams vsParams;
+        vsParams.ortho = glm::ortho(0.0f, io.DisplaySize.x, io.DisplaySize.y, 0.0f, -1.0f, 1.0f);
+        vsParams.rect = glm::vec4(p.rect.x, p.rect.y, p.rect.z, p.rect.w);
+        vsParams.scale = scale;
+        vsParams.plotColor = glm::vec4(p.color.x, p.color.y, p.color.z, p.color.w);
+        Gfx::ApplyUniformBlock(vsParams);
+    }
+    else {
+        scale.z = 1.0f / float(p.numValues);
+        scale.w = std::min(std::max(-p.scaleMin * scale.y, 0.0f), 1.0f);
+        IMUIPlotBarShader::vsParams vsParams;
+        vsParams.ortho = glm::ortho(0.0f, io.DisplaySize.x, io.DisplaySize.y, 0.0f, -1.0f, 1.0f);
+        vsParams.rect = glm::vec4(p.rect.x, p.rect.y, p.rect.z, p.rect.w);
+        vsParams.scale = scale;
+        vsParams.plotColor = glm::vec4(p.color.x, p.color.y, p.color.z, p.color.w);
+        Gfx::ApplyUniformBlock(vsParams);
+    }
+    Gfx::ApplyScissorRect((int)x0, (int)(io.DisplaySize.y - y1), (int)(x1 - x0), (int)(y1 - y0));
+    Gfx::Draw(0, p.numSamples);
+}
+
+//------------------------------------------------------------------------------
+void
+imguiPlotRenderer::Reset() {
+    this->plots.Clear();
+    this->samples.Clear();
+}
+
+//------------------------------------------------------------------------------
+void
+imguiPlotRenderer::Discard() {
+    for (const auto& im : this->meshes) {
+        if (im.mesh.IsValid()) {
+            Gfx::DestroyResources(im.label);
+        }
+    }
+    this->meshes.Clear();
+    this->Reset();
+}
+
+//------------------------------------------------------------------------------
+int
+imguiPlotRenderer::NumPlots() const {
+    return this->plots.Size();
+}
+
+//------------------------------------------------------------------------------
+imguiPlotRenderer::plotType
+imguiPlotRenderer::Type(int plotIndex) const {
+    return this->plots[plotIndex].type;
+}
+
+//------------------------------------------------------------------------------
+int
+imguiPlotRenderer::Bytes() const {
+    int bytes = 0;
+    for (const auto& im : this->meshes) {
+        bytes += im.capacity * sizeof(sample);
+    }
+    return bytes;
+}
+
+} // namespace _priv
+} // namespace Oryol
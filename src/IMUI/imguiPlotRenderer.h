@@ -0,0 +1,88 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::imguiPlotRenderer
+    @brief draw large sample arrays as lines or bars on the GPU
+
+    Instead of tessellating a plot into ImDrawVerts, the samples of a
+    plot are uploaded as instance data (one instance per line segment
+    or bar, 12 bytes each) and drawn as instanced quads which are
+    placed in the vertex shader. Plots are queued while the ImGui
+    frame is built and drawn from an ImDrawList user callback, so they
+    are correctly layered and clipped with the rest of the UI.
+
+    Each plot of a frame has its own instance mesh, since a draw call
+    can't start at an instance offset.
+*/
+#include "Core/Types.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Buffer.h"
+#include "Gfx/Gfx.h"
+#include "imgui.h"
+
+namespace Oryol {
+namespace _priv {
+
+class imguiPlotRenderer {
+public:
+    /// plot types, each has its own pipeline
+    enum plotType {
+        Lines = 0,
+        Histogram,
+        NumPlotTypes
+    };
+    /// the vertex layout of the per-instance sample data
+    static VertexLayout InstanceLayout();
+    /// the vertex layout of the shared quad mesh
+    static VertexLayout QuadLayout();
+    /// create the shared quad mesh (corner x in [0,1], y in [-1,1])
+    static Id CreateQuadMesh();
+
+    /// queue a plot for this frame, returns the plot index for Draw()
+    int Add(plotType type, const float* values, int numValues, float scaleMin, float scaleMax, const ImVec4& rect, const ImVec4& color);
+    /// upload the samples of all queued plots (once per frame before drawing), returns uploaded bytes
+    int Upload();
+    /// draw a queued plot
+    void Draw(int plotIndex, const Id& quadMesh, const Id& pipeline, const ImVec4& clipRect) const;
+    /// forget the queued plots
+    void Reset();
+    /// destroy the instance meshes
+    void Discard();
+    /// number of plots queued this frame
+    int NumPlots() const;
+    /// get the type of a queued plot
+    plotType Type(int plotIndex) const;
+    /// GPU memory used by the instance meshes
+    int Bytes() const;
+
+private:
+    /// instance data of one line segment or bar
+    struct sample {
+        float index;
+        float value;
+        float nextValue;
+    };
+    struct plot {
+        plotType type = Lines;
+        int firstSample = 0;
+        int numSamples = 0;
+        int numValues = 0;
+        float scaleMin = 0.0f;
+        float scaleMax = 0.0f;
+        ImVec4 rect;
+        ImVec4 color;
+    };
+    struct instanceMesh {
+        ResourceLabel label;
+        Id mesh;
+        int capacity = 0;
+    };
+    static const int MinInstanceCapacity = 1024;
+
+    Array<plot> plots;
+    Buffer samples;
+    Array<instanceMesh> meshes;
+};
+
+} // namespace _priv
+} // namespace Oryol
@@ -0,0 +1,119 @@
+//------------------------------------------------------------------------------
+//  imguiWorkerPool.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "imguiWorkerPool.h"
+#include "Core/Assertion.h"
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+imguiWorkerPool::~imguiWorkerPool() {
+    this->Discard();
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWorkerPool::Setup(int numWorkers) {
+    o_assert_dbg(0 == this->NumWorkers());
+    o_assert_dbg(numWorkers >= 0);
+    #if ORYOL_HAS_THREADS
+    this->stopRequested = false;
+    for (int i = 0; i < numWorkers; i++) {
+        this->threads.emplace_back(&imguiWorkerPool::workerLoop, this);
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWorkerPool::Discard() {
+    #if ORYOL_HAS_THREADS
+    if (!this->threads.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->stopRequested = true;
+        }
+        this->startCond.notify_all();
+        for (auto& thread : this->threads) {
+            thread.join();
+        }
+        this->threads.clear();
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+int
+imguiWorkerPool::NumWorkers() const {
+    #if ORYOL_HAS_THREADS
+    return int(this->threads.size());
+    #else
+    return 0;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWorkerPool::ParallelFor(int num, const std::function<void(int)>& func_) {
+    #if ORYOL_HAS_THREADS
+    if (!this->threads.empty() && (num > 1)) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->func = &func_;
+            this->numItems = num;
+            this->nextItem = 0;
+            this->numBusyWorkers = int(this->threads.size());
+            this->generation++;
+        }
+        this->startCond.notify_all();
+        this->runItems();
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->doneCond.wait(lock, [this] { return 0 == this->numBusyWorkers; });
+        this->func = nullptr;
+        return;
+    }
+    #endif
+    for (int i = 0; i < num; i++) {
+        func_(i);
+    }
+}
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+void
+imguiWorkerPool::runItems() {
+    int item;
+    while ((item = this->nextItem.fetch_add(1)) < this->numItems) {
+        (*this->func)(item);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWorkerPool::workerLoop() {
+    int lastGeneration = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->startCond.wait(lock, [this, lastGeneration] {
+                return this->stopRequested || (this->generation != lastGeneration);
+            });
+            if (this->stopRequested) {
+                return;
+            }
+            lastGeneration = this->generation;
+        }
+        this->runItems();
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->numBusyWorkers--;
+        }
+        this->doneCond.notify_one();
+    }
+}
+#endif
+
+} // namespace _priv
+} // namespace Oryol
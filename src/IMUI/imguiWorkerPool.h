@@ -0,0 +1,60 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::imguiWorkerPool
+    @brief small fork-join thread pool for the imgui render path
+
+    ParallelFor() distributes N independent work items over the worker
+    threads and the calling thread, and returns when all items are
+    done. On platforms without threads (ORYOL_HAS_THREADS == 0) no
+    workers are created and ParallelFor() runs all items on the
+    calling thread.
+*/
+#include "Core/Types.h"
+#include <functional>
+#if ORYOL_HAS_THREADS
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+class imguiWorkerPool {
+public:
+    /// destructor
+    ~imguiWorkerPool();
+    /// start the worker threads
+    void Setup(int numWorkers);
+    /// stop and join the worker threads
+    void Discard();
+    /// get number of worker threads (0 if not setup or no thread support)
+    int NumWorkers() const;
+    /// call func(i) for each i in [0, num) and wait until all calls have returned
+    void ParallelFor(int num, const std::function<void(int)>& func);
+
+private:
+    #if ORYOL_HAS_THREADS
+    /// worker thread entry
+    void workerLoop();
+    /// process work items until none are left
+    void runItems();
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable startCond;
+    std::condition_variable doneCond;
+    const std::function<void(int)>* func = nullptr;
+    int numItems = 0;
+    std::atomic<int> nextItem{0};
+    int generation = 0;
+    int numBusyWorkers = 0;
+    bool stopRequested = false;
+    #endif
+};
+
+} // namespace _priv
+} // namespace Oryol
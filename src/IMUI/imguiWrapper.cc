@@ -3,11 +3,19 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "imguiWrapper.h"
+#include "imguiKernels.h"
+#include "imguiFontCache.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <new>
 #include "Core/Assertion.h"
 #include "Input/Input.h"
+#include "Core/Time/Clock.h"
 #include "IMUIShaders.h"
 #include "glm/mat4x4.hpp"
 #include "glm/gtc/matrix_transform.hpp"
+#include "imgui_internal.h"
 
 namespace Oryol {
 namespace _priv {
@@ -15,29 +23,235 @@ namespace _priv {
 
 imguiWrapper* imguiWrapper::self = nullptr;
 
+// keys which are forwarded to ImGui
+static const Key::Code imguiKeys[] = {
+    Key::Tab, Key::Left, Key::Right, Key::Up, Key::Down, Key::Home, Key::End,
+    Key::Delete, Key::BackSpace, Key::Enter, Key::Escape,
+    Key::A, Key::C, Key::V, Key::X, Key::Y, Key::Z
+};
+static const Key::Code modifierKeys[] = {
+    Key::LeftControl, Key::RightControl, Key::LeftShift, Key::RightShift, Key::LeftAlt, Key::RightAlt
+};
+
+//------------------------------------------------------------------------------
+static int
+roundUpCapacity(int num, int minNum, int maxNum) {
+    int cap = minNum;
+    while ((cap < num) && (cap < maxNum)) {
+        cap *= 2;
+    }
+    return cap < maxNum ? cap : maxNum;
+}
+
+//------------------------------------------------------------------------------
+static void
+squaredDistance1D(float* f, int n, int stride, float* d, int* v, float* z) {
+    // Felzenszwalb/Huttenlocher: replaces each value in a row or column
+    // with the min over all samples q of (p - q)^2 + f(q), in linear time
+    // by building the lower envelope of the parabolas rooted at each q
+    const float inf = 1e20f;
+    int k = 0;
+    v[0] = 0;
+    z[0] = -inf;
+    z[1] = inf;
+    for (int q = 1; q < n; q++) {
+        float sq;
+        do {
+            const int r = v[k];
+            sq = ((f[q * stride] + float(q * q)) - (f[r * stride] + float(r * r))) / float(2 * (q - r));
+        }
+        while ((sq <= z[k]) && (--k > -1));
+        k++;
+        v[k] = q;
+        z[k] = sq;
+        z[k + 1] = inf;
+    }
+    k = 0;
+    for (int q = 0; q < n; q++) {
+        while (z[k + 1] < float(q)) {
+            k++;
+        }
+        const int r = v[k];
+        d[q] = float((q - r) * (q - r)) + f[r * stride];
+    }
+    for (int q = 0; q < n; q++) {
+        f[q * stride] = d[q];
+    }
+}
+
+//------------------------------------------------------------------------------
+static void
+distanceField(uint8_t* pixels, int stride, int x0, int y0, int w, int h, int spread, float* scratch, int* scratchIndices) {
+    // Exact signed distance transform of one glyph window of a coverage
+    // bitmap: each pixel gets the distance to the nearest pixel on the
+    // other side of the 0.5 coverage threshold, clamped to the spread
+    // radius. Both squared distance grids are computed separably (all
+    // columns, then all rows), scratch must hold 2*w*h + 2*max(w,h) + 1
+    // floats and scratchIndices max(w,h) ints.
+    const float inf = 1e20f;
+    const int n = std::max(w, h);
+    float* toInside = scratch;
+    float* toOutside = scratch + w * h;
+    float* d = toOutside + w * h;
+    float* z = d + n;
+    for (int y = 0; y < h; y++) {
+        const uint8_t* row = pixels + (y0 + y) * stride + x0;
+        for (int x = 0; x < w; x++) {
+            const bool inside = row[x] >= 128;
+            toInside[y * w + x] = inside ? 0.0f : inf;
+            toOutside[y * w + x] = inside ? inf : 0.0f;
+        }
+    }
+    for (float* grid : { toInside, toOutside }) {
+        for (int x = 0; x < w; x++) {
+            squaredDistance1D(grid + x, h, w, d, scratchIndices, z);
+        }
+        for (int y = 0; y < h; y++) {
+            squaredDistance1D(grid + y * w, w, 1, d, scratchIndices, z);
+        }
+    }
+    const float maxDist2 = float(spread * spread);
+    for (int y = 0; y < h; y++) {
+        uint8_t* row = pixels + (y0 + y) * stride + x0;
+        for (int x = 0; x < w; x++) {
+            // distance from the pixel center to the outline, positive inside
+            const bool inside = row[x] >= 128;
+            const float dist2 = inside ? toOutside[y * w + x] : toInside[y * w + x];
+            float dist = (dist2 > maxDist2) ? float(spread) : (sqrtf(dist2) - 0.5f);
+            if (!inside) {
+                dist = -dist;
+            }
+            const float val = 0.5f + dist / (2.0f * spread);
+            row[x] = uint8_t(std::min(std::max(val, 0.0f), 1.0f) * 255.0f + 0.5f);
+        }
+    }
+}
+
 //------------------------------------------------------------------------------
 void
 imguiWrapper::Setup(const IMUISetup& setup_) {
     o_assert_dbg(!this->IsValid());
     self = this;
     this->setup = setup_;
+    // distance field fonts live in a single-channel atlas, re-baking
+    // the atlas for dynamic glyphs isn't supported with them
+    o_assert_dbg(!(this->setup.SDFFonts && this->setup.DynamicGlyphs));
+    o_assert_dbg(!this->setup.SDFFonts || ((this->setup.SDFBakeHeight > 0.0f) && (this->setup.SDFSpread > 0)));
+    if (this->setup.SDFFonts) {
+        this->setup.Alpha8FontAtlas = true;
+        // without fwidth() the antialiasing width is one screen pixel
+        // at the smallest font scale, in distance field units
+        float minScale = (this->setup.numFonts > 0) ? FLT_MAX : 1.0f;
+        for (int i = 0; i < this->setup.numFonts; i++) {
+            minScale = std::min(minScale, this->setup.fonts[i].font_height / this->setup.SDFBakeHeight);
+        }
+        this->sdfFixedWidth = 1.0f / (2.0f * this->setup.SDFSpread * minScale);
+    }
     this->fonts.Fill(nullptr);
+    this->pendingFonts.Fill(nullptr);
+
+    this->imagePool.Setup(InitialImageCapacity);
+    if (this->setup.ImageAtlas) {
+        this->imageAtlas.Setup(this->setup.ImageAtlasPageSize, this->setup.ImageAtlasMaxImageSize, this->setup.ImageAtlasMaxPages);
+    }
+
+    // the default context, all contexts share one font atlas which
+    // is owned by the wrapper
+    this->fontAtlas = Memory::New<ImFontAtlas>();
+    this->createContext(IMUIContextSetup());
+    this->SetContext(0);
+
+    // parallel vertex/index assembly
+    if (this->setup.NumAssemblyWorkers > 0) {
+        this->workerPool.Setup(this->setup.NumAssemblyWorkers);
+    }
+
+    // create gfx resources
+    this->setupStaging();
+    this->resLabel = Gfx::PushResourceLabel();
+    this->setupMeshAndDrawState();
+    this->setupWhiteTexture();
+    this->setupFontTexture(this->setup);
+    Gfx::PopResourceLabel();
+
+    this->isValid = true;
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::Discard() {
+    o_assert_dbg(this->IsValid());
+    for (int ctxIndex = 0; ctxIndex < this->contexts.Size(); ctxIndex++) {
+        if (this->contexts[ctxIndex]) {
+            this->destroyContext(ctxIndex);
+        }
+    }
+    if (this->capture.IsWriting()) {
+        this->capture.EndWrite();
+    }
+    else if (this->capture.IsReading()) {
+        this->capture.EndRead();
+        this->replayContext = InvalidIndex;
+    }
+    this->contexts.Clear();
+    this->ctx = nullptr;
+    if (this->inputSubscribed) {
+        if (Input::IsValid()) {
+            Input::UnsubscribeEvents(this->inputCallbackId);
+        }
+        this->inputSubscribed = false;
+    }
+    if (this->pendingFontAtlas) {
+        #if ORYOL_HAS_THREADS
+        this->fontBakeThread.join();
+        #endif
+        this->fontBaker.Discard();
+        Memory::Delete(this->pendingFontAtlas);
+        this->pendingFontAtlas = nullptr;
+    }
+    this->fontAtlas->TexID = 0;
+    Memory::Delete(this->fontAtlas);
+    this->fontAtlas = nullptr;
+    Gfx::DestroyResources(this->fontTextureLabel);
+    Gfx::DestroyResources(this->resLabel);
+    this->pipelineSets.Clear();
+    this->discardStaging();
+    this->workerPool.Discard();
+    if (this->imageAtlas.IsValid()) {
+        this->imageAtlas.Discard();
+    }
+    this->imagePool.Discard();
+    this->isValid = false;
+    self = nullptr;
+}
 
-    this->freeImageSlots.Reserve(MaxImages);
-    for (int i = MaxImages-1; i>=0; i--) {
-        this->freeImageSlots.Add(i);
+//------------------------------------------------------------------------------
+int
+imguiWrapper::createContext(const IMUIContextSetup& ctxSetup) {
+    context* c = Memory::New<context>();
+    c->setup = ctxSetup;
+    c->lastActivityTime = Clock::Now();
+    c->numRequestedFrames = 1;
+    c->imguiContext = ImGui::CreateContext(this->fontAtlas);
+    // the default context gets its pipelines in setupMeshAndDrawState()
+    if (this->isValid) {
+        c->pipelineSet = this->lookupPipelineSet(ctxSetup);
     }
 
-    ImGui::CreateContext();
+    // the context must be current to configure it
+    ImGuiContext* prevContext = ImGui::GetCurrentContext();
+    ImGui::SetCurrentContext(c->imguiContext);
     ImGui::StyleColorsDark();
     ImGuiIO& io = ImGui::GetIO();
-    if (this->setup.IniFilename.IsValid()) {
+    io.UserData = c;
+    // only the default context saves settings and logs
+    if (this->contexts.Empty() && this->setup.IniFilename.IsValid()) {
         io.IniFilename = this->setup.IniFilename.AsCStr();
     }
     else {
         io.IniFilename = nullptr;
     }
-    if (this->setup.LogFilename.IsValid()) {
+    if (this->contexts.Empty() && this->setup.LogFilename.IsValid()) {
         io.LogFilename = this->setup.LogFilename.AsCStr();
     }
     else {
@@ -50,10 +264,14 @@ imguiWrapper::Setup(const IMUISetup& setup_) {
     io.KeyMap[ImGuiKey_RightArrow] = Key::Right;
     io.KeyMap[ImGuiKey_UpArrow] = Key::Up;
     io.KeyMap[ImGuiKey_DownArrow] = Key::Down;
+    io.KeyMap[ImGuiKey_PageUp] = Key::PageUp;
+    io.KeyMap[ImGuiKey_PageDown] = Key::PageDown;
     io.KeyMap[ImGuiKey_Home] = Key::Home;
     io.KeyMap[ImGuiKey_End] = Key::End;
+    io.KeyMap[ImGuiKey_Insert] = Key::Insert;
     io.KeyMap[ImGuiKey_Delete] = Key::Delete;
     io.KeyMap[ImGuiKey_Backspace] = Key::BackSpace;
+    io.KeyMap[ImGuiKey_Space] = Key::Space;
     io.KeyMap[ImGuiKey_Enter] = Key::Enter;
     io.KeyMap[ImGuiKey_Escape] = Key::Escape;
     io.KeyMap[ImGuiKey_A] = Key::A;
@@ -66,28 +284,64 @@ imguiWrapper::Setup(const IMUISetup& setup_) {
     io.RenderDrawListsFn = imguiRenderDrawLists;
 
     #if ORYOL_RASPBERRYPI
-    io.MouseDrawCursor = true;
+    io.MouseDrawCursor = ctxSetup.ReceiveInput;
     #endif
+    ImGui::SetCurrentContext(prevContext);
 
-    // create gfx resources
-    this->resLabel = Gfx::PushResourceLabel();
-    this->setupMeshAndDrawState();
-    this->setupWhiteTexture();
-    this->setupFontTexture(this->setup);
-    Gfx::PopResourceLabel();
-
-    this->isValid = true;
+    // reuse the slot of a destroyed context
+    for (int ctxIndex = 0; ctxIndex < this->contexts.Size(); ctxIndex++) {
+        if (nullptr == this->contexts[ctxIndex]) {
+            this->contexts[ctxIndex] = c;
+            return ctxIndex;
+        }
+    }
+    this->contexts.Add(c);
+    return this->contexts.Size() - 1;
 }
 
 //------------------------------------------------------------------------------
 void
-imguiWrapper::Discard() {
+imguiWrapper::destroyContext(int ctxIndex) {
+    context* c = this->contexts[ctxIndex];
+    o_assert_dbg(c);
+    for (const auto& chunk : c->chunks) {
+        if (chunk.mesh().IsValid()) {
+            Gfx::DestroyResources(chunk.label);
+        }
+    }
+    c->plots.Discard();
+    ImGui::DestroyContext(c->imguiContext);
+    Memory::Delete(c);
+    this->contexts[ctxIndex] = nullptr;
+}
+
+//------------------------------------------------------------------------------
+int
+imguiWrapper::CreateContext(const IMUIContextSetup& ctxSetup) {
     o_assert_dbg(this->IsValid());
-    ImGui::GetIO().Fonts->TexID = 0;
-    ImGui::DestroyContext();
-    Gfx::DestroyResources(this->resLabel);
-    this->isValid = false;
-    self = nullptr;
+    return this->createContext(ctxSetup);
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::DestroyContext(int ctxIndex) {
+    o_assert_dbg((ctxIndex > 0) && (ctxIndex < this->contexts.Size()));
+    o_assert_dbg(this->contexts[ctxIndex] != this->ctx);
+    this->destroyContext(ctxIndex);
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::SetContext(int ctxIndex) {
+    o_assert_dbg((ctxIndex >= 0) && (ctxIndex < this->contexts.Size()) && this->contexts[ctxIndex]);
+    this->ctx = this->contexts[ctxIndex];
+    ImGui::SetCurrentContext(this->ctx->imguiContext);
+}
+
+//------------------------------------------------------------------------------
+int
+imguiWrapper::Context() const {
+    return this->contexts.FindIndexLinear(this->ctx);
 }
 
 //------------------------------------------------------------------------------
@@ -112,233 +366,2087 @@ imguiWrapper::setupWhiteTexture() {
     texSetup.Sampler.MagFilter = TextureFilterMode::Nearest;
     texSetup.ImageData.Sizes[0][0] = sizeof(pixels);
     this->whiteTexture = Gfx::CreateResource(texSetup, pixels, sizeof(pixels));
+    this->textureBytes += sizeof(pixels);
 }
 
 //------------------------------------------------------------------------------
 void
 imguiWrapper::setupFontTexture(const IMUISetup& setup) {
     ImGuiIO& io = ImGui::GetIO();
+    const TimePoint startTime = Clock::Now();
+
+    // try to restore the baked atlas from the font cache (this is
+    // pointless when the glyph set changes at runtime), the key hashes
+    // all TTF data, so it's only computed if a cache is read or written
+    const bool useCache = !setup.DynamicGlyphs && (setup.FontCacheData || setup.FontCacheWriteFunc);
+    const uint64_t cacheKey = useCache ? imguiFontCache::ComputeKey(setup) : 0;
+    StaticArray<int, MaxNumFonts> fontIndices;
+    bool cacheHit = false;
+    if (useCache && setup.FontCacheData) {
+        cacheHit = imguiFontCache::Load(io.Fonts, cacheKey, setup.FontCacheData, setup.FontCacheSize, &fontIndices[0], setup.numFonts);
+    }
+    // with async baking only ImGui's default font is baked right
+    // away, the setup fonts are baked into a separate atlas on a
+    // thread and swapped in by finishFontBake()
+    #if ORYOL_HAS_THREADS
+    const bool asyncBake = setup.AsyncFontBake && !setup.DynamicGlyphs && !cacheHit && (setup.numFonts > 0);
+    #else
+    const bool asyncBake = false;
+    #endif
+    if (cacheHit) {
+        for (int i = 0; i < setup.numFonts; i++) {
+            this->fonts[i] = io.Fonts->Fonts[fontIndices[i]];
+        }
+    }
+    else if (asyncBake) {
+        ImFont* defaultFont = io.Fonts->AddFontDefault();
+        for (int i = 0; i < setup.numFonts; i++) {
+            this->fonts[i] = defaultFont;
+        }
+        #if ORYOL_HAS_THREADS
+        this->pendingFontAtlas = Memory::New<ImFontAtlas>();
+        this->addFonts(this->pendingFontAtlas, &this->pendingFonts[0]);
+        this->fontBaker.Setup(this->pendingFontAtlas, this->setup.SDFFonts ? 1 : 0);
+        this->fontBakeDone = false;
+        this->fontBakeThread = std::thread([this]() {
+            // only the glyph rasterization and the distance field run
+            // here, neither calls into ImGui, and the pending atlas isn't
+            // reachable by the main thread until fontBakeDone is set;
+            // everything that allocates through ImGui (glyph tables,
+            // ImFont copies, RGBA conversion) happens in finishFontBake()
+            if (this->fontBaker.Bake() && this->setup.SDFFonts) {
+                this->bakeSDFAtlas(this->fontBaker);
+            }
+            this->fontBakeDone = true;
+        });
+        #endif
+    }
+    else {
+        this->addFonts(io.Fonts, &this->fonts[0]);
+        if (setup.SDFFonts) {
+            this->fontBaker.Setup(io.Fonts, 1);
+            if (this->fontBaker.Bake()) {
+                this->bakeSDFAtlas(this->fontBaker);
+            }
+            this->fontBaker.Finish();
+            this->finishSDFAtlas(io.Fonts, &this->fonts[0]);
+        }
+    }
+
+    this->createFontTexture();
+    io.Fonts->TexID = this->AllocImage();
+    this->BindImage(io.Fonts->TexID, this->fontTexture);
 
-    io.Fonts->AddFontDefault();
-    for (int i = 0; i < setup.numFonts; i++) {
-        const auto& desc = setup.fonts[i];
+    // hand a new cache blob to the app if the atlas had to be baked
+    if (useCache && !cacheHit && !asyncBake) {
+        this->saveFontCache(cacheKey);
+    }
+
+    this->fontBakeStartTime = startTime;
+    this->fontBakeSaveCache = useCache && asyncBake;
+    this->fontAtlasInfo.CacheKey = cacheKey;
+    this->fontAtlasInfo.LoadedFromCache = cacheHit;
+    this->fontAtlasInfo.SetupTime = Clock::Since(startTime);
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::addFonts(ImFontAtlas* atlas, ImFont** outFonts) {
+    // distance field glyphs need room for the field around them
+    if (this->setup.SDFFonts) {
+        atlas->TexGlyphPadding = 2 * this->setup.SDFSpread + 1;
+    }
+    atlas->AddFontDefault();
+    for (int i = 0; i < this->setup.numFonts; i++) {
+        const auto& desc = this->setup.fonts[i];
         desc.font_config->FontDataOwnedByAtlas = false;
+        float height = desc.font_height;
+        if (this->setup.SDFFonts) {
+            // a typeface is only baked once, other sizes get a scaled
+            // copy of its ImFont in finishSDFAtlas()
+            if (this->sdfSourceFont(i) != i) {
+                outFonts[i] = nullptr;
+                continue;
+            }
+            height = this->setup.SDFBakeHeight;
+            desc.font_config->OversampleH = 1;
+            desc.font_config->OversampleV = 1;
+            desc.font_config->PixelSnapH = false;
+        }
+        const ImWchar* ranges = this->setup.DynamicGlyphs ? this->buildDynamicGlyphRanges(i) : desc.glyph_ranges;
         if (desc.compressed) {
-            this->fonts[i] = io.Fonts->AddFontFromMemoryCompressedTTF(desc.ttf_data, desc.ttf_size, desc.font_height, desc.font_config, desc.glyph_ranges);
+            outFonts[i] = atlas->AddFontFromMemoryCompressedTTF(desc.ttf_data, desc.ttf_size, height, desc.font_config, ranges);
         }
         else {
-            this->fonts[i] = io.Fonts->AddFontFromMemoryTTF(desc.ttf_data, desc.ttf_size, desc.font_height, desc.font_config, desc.glyph_ranges);
+            outFonts[i] = atlas->AddFontFromMemoryTTF(desc.ttf_data, desc.ttf_size, height, desc.font_config, ranges);
         }
-        o_assert_dbg(this->fonts[i]);
+        o_assert_dbg(outFonts[i]);
     }
+}
 
-    unsigned char* pixels;
-    int width, height;
-    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
-    const int imgSize = width * height * sizeof(uint32_t);
+//------------------------------------------------------------------------------
+int
+imguiWrapper::sdfSourceFont(int fontIndex) const {
+    // fonts which are merged, or have fonts merged into them, always
+    // get their own ImFont
+    const auto canShare = [this](int i) {
+        const bool merged = this->setup.fonts[i].font_config->MergeMode;
+        const bool mergeTarget = ((i + 1) < this->setup.numFonts) && this->setup.fonts[i + 1].font_config->MergeMode;
+        return !merged && !mergeTarget;
+    };
+    if (!canShare(fontIndex)) {
+        return fontIndex;
+    }
+    const auto& desc = this->setup.fonts[fontIndex];
+    for (int i = 0; i < fontIndex; i++) {
+        const auto& other = this->setup.fonts[i];
+        if (canShare(i) &&
+            (other.ttf_data == desc.ttf_data) &&
+            (other.ttf_size == desc.ttf_size) &&
+            (other.compressed == desc.compressed) &&
+            (other.glyph_ranges == desc.glyph_ranges) &&
+            (other.font_config->FontNo == desc.font_config->FontNo)) {
+            return i;
+        }
+    }
+    return fontIndex;
+}
 
-    auto texSetup = TextureSetup::FromPixelData2D(width, height, 1, PixelFormat::RGBA8);
-    texSetup.Sampler.WrapU = TextureWrapMode::ClampToEdge;
-    texSetup.Sampler.WrapV = TextureWrapMode::ClampToEdge;
-    texSetup.Sampler.MinFilter = TextureFilterMode::Nearest;
-    texSetup.Sampler.MagFilter = TextureFilterMode::Nearest;
-    texSetup.ImageData.Sizes[0][0] = imgSize;
-    this->fontTexture = Gfx::CreateResource(texSetup, pixels, imgSize);
-    this->drawState.FSTexture[IMUIShader::tex] = this->fontTexture;
+//------------------------------------------------------------------------------
+void
+imguiWrapper::bakeSDFAtlas(imguiFontBaker& baker) {
+    // only the glyphs of the setup TTF fonts become distance fields, each
+    // in a window which grows the glyph by the spread; ImGui's default
+    // bitmap font (the first font config) is baked into the coverage band
+    // at the top of the atlas and stays untouched, like the custom rects
+    // (white pixel, mouse cursors) which imguiFontBaker::Finish() renders
+    // later; glyphs are padded by 2 * spread + 1, so the windows don't
+    // overlap each other or the coverage band
+    uint8_t* pixels = baker.Pixels();
+    const int width = baker.Width();
+    const int height = baker.Height();
+    const int spread = this->setup.SDFSpread;
+    int maxArea = 0;
+    int maxSize = 0;
+    for (const auto& rect : baker.GlyphRects()) {
+        if (rect.config > 0) {
+            const int w = rect.w + 2 * spread;
+            const int h = rect.h + 2 * spread;
+            maxArea = std::max(maxArea, w * h);
+            maxSize = std::max(maxSize, std::max(w, h));
+        }
+    }
+    if (0 == maxArea) {
+        return;
+    }
+    float* scratch = (float*) Memory::Alloc((2 * maxArea + 2 * maxSize + 1) * int(sizeof(float)));
+    int* scratchIndices = (int*) Memory::Alloc(maxSize * int(sizeof(int)));
+    for (const auto& rect : baker.GlyphRects()) {
+        if (rect.config > 0) {
+            const int x0 = std::max(rect.x - spread, 0);
+            const int y0 = std::max(rect.y - spread, 0);
+            const int x1 = std::min(rect.x + rect.w + spread, width);
+            const int y1 = std::min(rect.y + rect.h + spread, height);
+            distanceField(pixels, width, x0, y0, x1 - x0, y1 - y0, spread, scratch, scratchIndices);
+        }
+    }
+    Memory::Free(scratchIndices);
+    Memory::Free(scratch);
+}
 
-    io.Fonts->TexID = this->AllocImage();
-    this->BindImage(io.Fonts->TexID, this->fontTexture);
+//------------------------------------------------------------------------------
+void
+imguiWrapper::finishSDFAtlas(ImFontAtlas* atlas, ImFont** fonts) {
+    // grow the quads of the distance field glyphs so that they cover the
+    // field outside the glyph outline (glyphs are baked without
+    // oversampling, so one atlas pixel is one glyph unit), the lookup
+    // tables only contain advances and are not affected; the glyphs of
+    // ImGui's default font (the first font config, setup fonts may be
+    // merged into it) are coverage bitmaps
+    o_assert_dbg(atlas->ConfigData.Size > 0);
+    const ImFont* defaultFont = atlas->ConfigData[0].DstFont;
+    const ImWchar* defaultRanges = atlas->ConfigData[0].GlyphRanges ? atlas->ConfigData[0].GlyphRanges : atlas->GetGlyphRangesDefault();
+    const int spread = this->setup.SDFSpread;
+    const float du = float(spread) / float(atlas->TexWidth);
+    const float dv = float(spread) / float(atlas->TexHeight);
+    for (ImFont* font : atlas->Fonts) {
+        for (ImFontGlyph& glyph : font->Glyphs) {
+            const bool defaultGlyph = (font == defaultFont) && inGlyphRanges(defaultRanges, glyph.Codepoint);
+            if ((glyph.X0 < glyph.X1) && (glyph.Y0 < glyph.Y1) && !defaultGlyph) {
+                glyph.X0 -= spread; glyph.Y0 -= spread;
+                glyph.X1 += spread; glyph.Y1 += spread;
+                glyph.U0 -= du; glyph.V0 -= dv;
+                glyph.U1 += du; glyph.V1 += dv;
+            }
+        }
+    }
+
+    // other sizes of a typeface share its glyphs through a copy of
+    // its ImFont, each font scales the baked size to its font_height
+    for (int i = 0; i < this->setup.numFonts; i++) {
+        const auto& desc = this->setup.fonts[i];
+        if (nullptr == fonts[i]) {
+            const ImFont* src = fonts[this->sdfSourceFont(i)];
+            ImFont* font = new (ImGui::MemAlloc(sizeof(ImFont))) ImFont();
+            font->ContainerAtlas = atlas;
+            font->ConfigData = src->ConfigData;
+            font->ConfigDataCount = src->ConfigDataCount;
+            font->FontSize = src->FontSize;
+            font->Ascent = src->Ascent;
+            font->Descent = src->Descent;
+            font->DisplayOffset = src->DisplayOffset;
+            font->Glyphs.resize(src->Glyphs.size());
+            Memory::Copy(src->Glyphs.Data, font->Glyphs.Data, src->Glyphs.size() * sizeof(ImFontGlyph));
+            font->SetFallbackChar(src->FallbackChar);
+            atlas->Fonts.push_back(font);
+            fonts[i] = font;
+        }
+        if (!desc.font_config->MergeMode) {
+            fonts[i]->Scale = desc.font_height / this->setup.SDFBakeHeight;
+        }
+    }
 }
 
 //------------------------------------------------------------------------------
 void
-imguiWrapper::setupMeshAndDrawState() {
-    MeshSetup meshSetup = MeshSetup::Empty(MaxNumVertices, Usage::Stream, IndexType::Index16, MaxNumIndices, Usage::Stream);
-    meshSetup.Layout
-        .Add(VertexAttr::Position, VertexFormat::Float2)
-        .Add(VertexAttr::TexCoord0, VertexFormat::Float2)
-        .Add(VertexAttr::Color0, VertexFormat::UByte4N);
-    o_assert_dbg(meshSetup.Layout.ByteSize() == sizeof(ImDrawVert));
-    this->drawState.Mesh[0] = Gfx::CreateResource(meshSetup);
-    o_assert(this->drawState.Mesh[0].IsValid());
-    o_assert(Gfx::QueryResourceInfo(this->drawState.Mesh[0]).State == ResourceState::Valid);
-
-    Id shd = Gfx::CreateResource(IMUIShader::Setup());
-    auto ps = PipelineSetup::FromLayoutAndShader(meshSetup.Layout, shd);
-    ps.DepthStencilState.DepthWriteEnabled = false;
-    ps.DepthStencilState.DepthCmpFunc = CompareFunc::Always;
-    ps.BlendState.BlendEnabled = true;
-    ps.BlendState.SrcFactorRGB = BlendFactor::SrcAlpha;
-    ps.BlendState.DstFactorRGB = BlendFactor::OneMinusSrcAlpha;
-    ps.BlendState.ColorFormat = Gfx::DisplayAttrs().ColorPixelFormat;
-    ps.BlendState.DepthFormat = Gfx::DisplayAttrs().DepthPixelFormat;
-    ps.BlendState.ColorWriteMask = PixelChannel::RGB;
-    ps.RasterizerState.ScissorTestEnabled = true;
-    ps.RasterizerState.CullFaceEnabled = false;
-    ps.RasterizerState.SampleCount = Gfx::DisplayAttrs().SampleCount;
-    this->drawState.Pipeline = Gfx::CreateResource(ps);
+imguiWrapper::saveFontCache(uint64_t cacheKey) {
+    if (!this->setup.FontCacheWriteFunc) {
+        return;
+    }
+    // merged fonts share the ImFont of the font they were merged into
+    StaticArray<int, MaxNumFonts> fontIndices;
+    for (int i = 0; i < this->setup.numFonts; i++) {
+        fontIndices[i] = 0;
+        for (int fontIndex = 0; fontIndex < this->fontAtlas->Fonts.size(); fontIndex++) {
+            if (this->fontAtlas->Fonts[fontIndex] == this->fonts[i]) {
+                fontIndices[i] = fontIndex;
+                break;
+            }
+        }
+    }
+    Buffer cacheData;
+    imguiFontCache::Save(this->fontAtlas, cacheKey, &fontIndices[0], this->setup.numFonts, cacheData);
+    this->setup.FontCacheWriteFunc(cacheData.Data(), cacheData.Size());
 }
 
 //------------------------------------------------------------------------------
-ImTextureID
-imguiWrapper::AllocImage() {
-    o_assert_dbg(!this->freeImageSlots.Empty());
-    return ImTextureID(this->freeImageSlots.PopBack());
+bool
+imguiWrapper::FontsReady() const {
+    return nullptr == this->pendingFontAtlas;
 }
 
 //------------------------------------------------------------------------------
 void
-imguiWrapper::FreeImage(ImTextureID img) {
-    int slot = int(intptr_t(img));
-    o_assert_dbg(this->images[slot].IsValid());
-    this->images[slot].Invalidate();
+imguiWrapper::WaitForFonts() {
+    if (this->pendingFontAtlas) {
+        this->finishFontBake();
+    }
 }
 
 //------------------------------------------------------------------------------
 void
-imguiWrapper::BindImage(ImTextureID img, Id texId) {
-    int slot = int(intptr_t(img));
-    o_assert_dbg(!this->images[slot].IsValid());
-    this->images[slot] = texId;
+imguiWrapper::finishFontBake() {
+    o_assert_dbg(this->pendingFontAtlas);
+    #if ORYOL_HAS_THREADS
+    this->fontBakeThread.join();
+    o_assert_dbg(this->fontBakeDone);
+    #endif
+    this->fontBaker.Finish();
+    if (this->setup.SDFFonts) {
+        this->finishSDFAtlas(this->pendingFontAtlas, &this->pendingFonts[0]);
+    }
+
+    // all contexts switch to the new atlas, the ImFont pointers of the
+    // old atlas (the default font returned by IMUI::Font() so far) are
+    // gone after this point
+    ImFontAtlas* oldAtlas = this->fontAtlas;
+    this->fontAtlas = this->pendingFontAtlas;
+    this->pendingFontAtlas = nullptr;
+    for (context* c : this->contexts) {
+        if (c) {
+            o_assert_dbg((0 == c->imguiContext->FrameCount) || (c->imguiContext->FrameCountEnded == c->imguiContext->FrameCount));
+            c->imguiContext->IO.Fonts = this->fontAtlas;
+        }
+    }
+    for (int i = 0; i < this->setup.numFonts; i++) {
+        this->fonts[i] = this->pendingFonts[i];
+        this->pendingFonts[i] = nullptr;
+    }
+    const ImTextureID texId = oldAtlas->TexID;
+    oldAtlas->TexID = 0;
+    Memory::Delete(oldAtlas);
+
+    // re-create the font texture and rebind the atlas ImTextureID
+    Gfx::DestroyResources(this->fontTextureLabel);
+    this->textureBytes -= this->fontAtlasBytes;
+    this->createFontTexture();
+    this->fontAtlas->TexID = texId;
+    this->imagePool.Bind(texId, this->fontTexture);
+
+    if (this->fontBakeSaveCache) {
+        this->saveFontCache(this->fontAtlasInfo.CacheKey);
+    }
+    this->fontAtlasInfo.SetupTime = Clock::Since(this->fontBakeStartTime);
 }
 
 //------------------------------------------------------------------------------
 void
-imguiWrapper::NewFrame(float frameDurationInSeconds) {
-
+imguiWrapper::createFontTexture() {
     ImGuiIO& io = ImGui::GetIO();
-    DisplayAttrs dispAttrs = Gfx::PassAttrs();
-    o_assert_dbg((dispAttrs.FramebufferWidth > 0) && (dispAttrs.FramebufferHeight > 0));
-    io.DisplaySize = ImVec2((float)dispAttrs.FramebufferWidth, (float)dispAttrs.FramebufferHeight);
-    io.DeltaTime = frameDurationInSeconds;
 
-    // transfer input
-    if (Input::IsValid()) {
-        if (Input::MouseAttached()) {
-            io.MousePos.x = Input::MousePosition().x;
-            io.MousePos.y = Input::MousePosition().y;
-            io.MouseWheel = Input::MouseScroll().y;
-            for (int btn = 0; btn < 3; btn++) {
-                io.MouseDown[btn] = Input::MouseButtonDown((MouseButton::Code)btn)||Input::MouseButtonPressed((MouseButton::Code)btn);
-            }
+    // the font atlas is either baked as RGBA8 (all pixels white, coverage
+    // in alpha), or as a single-channel texture which is 4x smaller
+    // but needs a separate shader
+    unsigned char* pixels;
+    int width, height;
+    PixelFormat::Code pixelFormat;
+    if (this->setup.Alpha8FontAtlas) {
+        io.Fonts->GetTexDataAsAlpha8(&pixels, &width, &height);
+        pixelFormat = PixelFormat::L8;
+    }
+    else {
+        io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+        pixelFormat = PixelFormat::RGBA8;
+    }
+    const int imgSize = width * height * PixelFormat::ByteSize(pixelFormat);
+
+    auto texSetup = TextureSetup::FromPixelData2D(width, height, 1, pixelFormat);
+    texSetup.Sampler.WrapU = TextureWrapMode::ClampToEdge;
+    texSetup.Sampler.WrapV = TextureWrapMode::ClampToEdge;
+    // distance fields are interpolated, bitmap glyphs are drawn 1:1
+    const TextureFilterMode::Code filter = this->setup.SDFFonts ? TextureFilterMode::Linear : TextureFilterMode::Nearest;
+    texSetup.Sampler.MinFilter = filter;
+    texSetup.Sampler.MagFilter = filter;
+    texSetup.ImageData.Sizes[0][0] = imgSize;
+    this->fontTextureLabel = Gfx::PushResourceLabel();
+    this->fontTexture = Gfx::CreateResource(texSetup, pixels, imgSize);
+    Gfx::PopResourceLabel();
+    this->textureBytes += imgSize;
+    this->fontAtlasBytes = imgSize;
+    this->drawState.FSTexture[IMUIShader::tex] = this->fontTexture;
+    this->fontAtlasInfo.Width = width;
+    this->fontAtlasInfo.Height = height;
+
+    // the SDF shader draws everything above the bottom of the coverage
+    // band as plain coverage (before an async bake finishes that's the
+    // whole atlas, it only has ImGui's default font)
+    if (this->setup.SDFFonts) {
+        this->sdfCoverageV = float(coverageBandHeight(io.Fonts)) / float(height);
+    }
+}
+
+//------------------------------------------------------------------------------
+int
+imguiWrapper::coverageBandHeight(const ImFontAtlas* atlas) {
+    // the custom rects and the glyphs of ImGui's default font (always the
+    // first font, setup fonts merged into it add glyphs outside the
+    // default ranges) are baked into the band by imguiFontBaker, this
+    // also works for atlases restored from the font cache
+    int bandHeight = 0;
+    for (const ImFontAtlas::CustomRect& rect : atlas->CustomRects) {
+        if (rect.IsPacked()) {
+            bandHeight = std::max(bandHeight, rect.Y + rect.Height);
         }
-        if (Input::TouchpadAttached()) {
-            if (Input::TouchStarted() || Input::TouchPanning()) {
-                const glm::vec2& touchPos = Input::TouchPosition(0);
-                io.MousePos.x = touchPos.x;
-                io.MousePos.y = touchPos.y;
-                io.MouseDown[0] = true;
-            }
-            else if (Input::TouchEnded() || Input::TouchCancelled()) {
-                const glm::vec2& touchPos = Input::TouchPosition(0);
-                io.MousePos.x = touchPos.x;
-                io.MousePos.y = touchPos.y;
-                io.MouseDown[0] = false;
+    }
+    if (atlas->Fonts.Size > 0) {
+        const ImWchar* defaultRanges = atlas->GetGlyphRangesDefault();
+        for (const ImFontGlyph& glyph : atlas->Fonts[0]->Glyphs) {
+            if (inGlyphRanges(defaultRanges, glyph.Codepoint)) {
+                bandHeight = std::max(bandHeight, int(ceilf(glyph.V1 * atlas->TexHeight)));
             }
         }
-        if (Input::KeyboardAttached()) {
-            const wchar_t* text = Input::Text();
-            while (wchar_t c = *text++) {
-                io.AddInputCharacter((unsigned short)c);
-            }
-            io.KeyCtrl  = Input::KeyPressed(Key::LeftControl) || Input::KeyPressed(Key::RightControl);
-            io.KeyShift = Input::KeyPressed(Key::LeftShift) || Input::KeyPressed(Key::RightShift);
-            io.KeyAlt   = Input::KeyPressed(Key::LeftAlt) || Input::KeyPressed(Key::RightAlt);
-
-            const static Key::Code keys[] = {
-                Key::Tab, Key::Left, Key::Right, Key::Up, Key::Down, Key::Home, Key::End,
-                Key::Delete, Key::BackSpace, Key::Enter, Key::Escape,
-                Key::A, Key::C, Key::V, Key::X, Key::Y, Key::Z
-            };
-            for (auto key : keys) {
-                io.KeysDown[key] = Input::KeyDown(key)|Input::KeyPressed(key);;
-            }
+    }
+    return bandHeight;
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiWrapper::inGlyphRanges(const ImWchar* ranges, unsigned int c) {
+    for (; ranges[0]; ranges += 2) {
+        if ((c >= ranges[0]) && (c <= ranges[1])) {
+            return true;
         }
     }
-    ImGui::NewFrame();
+    return false;
 }
 
 //------------------------------------------------------------------------------
-void
-imguiWrapper::imguiRenderDrawLists(ImDrawData* draw_data) {
-    o_assert_dbg(self);
-    o_assert_dbg(draw_data);
+const ImWchar*
+imguiWrapper::buildDynamicGlyphRanges(int fontIndex) {
+    // the resident Latin-1 glyphs and the dynamic glyphs, both clipped
+    // against the glyph ranges the font was set up with
+    const ImWchar* fontRanges = this->setup.fonts[fontIndex].glyph_ranges;
+    if (nullptr == fontRanges) {
+        fontRanges = ImGui::GetIO().Fonts->GetGlyphRangesDefault();
+    }
+    ImFontAtlas::GlyphRangesBuilder builder;
+    bool empty = true;
+    for (const ImWchar* range = fontRanges; range[0]; range += 2) {
+        for (unsigned int c = range[0]; (c <= range[1]) && (c <= MaxResidentGlyph); c++) {
+            builder.AddChar(ImWchar(c));
+            empty = false;
+        }
+    }
+    for (int i = 0; i < this->dynamicGlyphs.Size(); i++) {
+        const ImWchar c = this->dynamicGlyphs.KeyAtIndex(i);
+        if (inGlyphRanges(fontRanges, c)) {
+            builder.AddChar(c);
+            empty = false;
+        }
+    }
+    // a font without any glyphs has no fallback glyph either
+    if (empty) {
+        builder.AddChar(fontRanges[0]);
+    }
+    ImVector<ImWchar>& ranges = this->dynamicGlyphRanges[fontIndex];
+    ranges.clear();
+    builder.BuildRanges(&ranges);
+    return ranges.Data;
+}
 
-    if (draw_data->CmdListsCount == 0) {
+//------------------------------------------------------------------------------
+void
+imguiWrapper::UseGlyphs(const char* text) {
+    o_assert_dbg(text);
+    if (!this->setup.DynamicGlyphs) {
         return;
     }
-
-    // copy over vertices into single vertex buffer
-    int numVertices = 0;
-    int numIndices = 0;
-    int numCmdLists;
-    for (numCmdLists = 0; numCmdLists < draw_data->CmdListsCount; numCmdLists++) {
-
-        const ImDrawList* cmd_list = draw_data->CmdLists[numCmdLists];
-        const int cmdListNumVertices = cmd_list->VtxBuffer.size();
-        const int cmdListNumIndices  = cmd_list->IdxBuffer.size();
-
-        // overflow check
-        if (((numVertices + cmdListNumVertices) > imguiWrapper::MaxNumVertices) ||
-            ((numIndices + cmdListNumIndices) > imguiWrapper::MaxNumIndices)) {
+    while (*text) {
+        unsigned int c = 0;
+        text += ImTextCharFromUtf8(&c, text, nullptr);
+        if (0 == c) {
             break;
         }
-        // copy vertices
-        Memory::Copy((const void*)&cmd_list->VtxBuffer.front(),
-                     &(self->vertexData[numVertices]),
-                     cmdListNumVertices * sizeof(ImDrawVert));
+        this->useGlyph(c);
+    }
+}
 
-        // need to copy indices one by one and add the current base vertex index :/
-        const ImDrawIdx* srcIndexPtr = &cmd_list->IdxBuffer.front();
-        const uint16_t baseVertexIndex = numVertices;
-        for (int i = 0; i < cmdListNumIndices; i++) {
-            self->indexData[numIndices++] = srcIndexPtr[i] + baseVertexIndex;
+//------------------------------------------------------------------------------
+void
+imguiWrapper::useGlyph(unsigned int c) {
+    if ((c <= MaxResidentGlyph) || (c > 0xFFFF)) {
+        return;
+    }
+    const int frame = this->frameCount;
+    const int index = this->dynamicGlyphs.FindIndex(ImWchar(c));
+    if (InvalidIndex != index) {
+        this->dynamicGlyphs.ValueAtIndex(index) = frame;
+        return;
+    }
+    // only add glyphs which one of the fonts can provide, otherwise
+    // each use of the glyph would trigger a pointless re-bake
+    for (int i = 0; i < this->setup.numFonts; i++) {
+        const ImWchar* ranges = this->setup.fonts[i].glyph_ranges;
+        if (ranges && inGlyphRanges(ranges, c)) {
+            this->dynamicGlyphs.Add(ImWchar(c), frame);
+            this->dynamicGlyphsDirty = true;
+            for (context* ctx : this->contexts) {
+                if (ctx && (ctx->numRequestedFrames < 1)) {
+                    ctx->numRequestedFrames = 1;
+                }
+            }
+            return;
         }
-        numVertices += cmdListNumVertices;
     }
+}
 
-    // draw command lists
-    IMUIShader::vsParams vsParams;
-    const float width  = ImGui::GetIO().DisplaySize.x;
-    const float height = ImGui::GetIO().DisplaySize.y;
-    vsParams.ortho = glm::ortho(0.0f, width, height, 0.0f, -1.0f, 1.0f);
-    const int vertexDataSize = numVertices * sizeof(ImDrawVert);
-    const int indexDataSize = numIndices * sizeof(ImDrawIdx);
+//------------------------------------------------------------------------------
+void
+imguiWrapper::rebuildFontAtlas() {
+    o_assert_dbg(this->setup.DynamicGlyphs);
 
-    Gfx::UpdateVertices(self->drawState.Mesh[0], self->vertexData, vertexDataSize);
-    Gfx::UpdateIndices(self->drawState.Mesh[0], self->indexData, indexDataSize);
-    Id curTexture;
-    int elmOffset = 0;
-    for (int cmdListIndex = 0; cmdListIndex < numCmdLists; cmdListIndex++) {
-        const ImDrawList* cmd_list = draw_data->CmdLists[cmdListIndex];
-        const ImDrawCmd* pcmd_end = cmd_list->CmdBuffer.end();
-        for (const ImDrawCmd* pcmd = cmd_list->CmdBuffer.begin(); pcmd != pcmd_end; pcmd++) {
-            if (pcmd->UserCallback) {
-                pcmd->UserCallback(cmd_list, pcmd);
-            }
-            else {
-                const Id& newTexture = self->images[int(intptr_t(pcmd->TextureId))];
-                if (curTexture != newTexture) {
-                    if (newTexture.IsValid()) {
-                        self->drawState.FSTexture[IMUIShader::tex] = newTexture;
-                    }
-                    else {
-                        self->drawState.FSTexture[IMUIShader::tex] = self->whiteTexture;
-                    }
-                    curTexture = newTexture;
-                    Gfx::ApplyDrawState(self->drawState);
-                    Gfx::ApplyUniformBlock(vsParams);
-                }
-                Gfx::ApplyScissorRect((int)pcmd->ClipRect.x,
-                                      (int)(height - pcmd->ClipRect.w),
-                                      (int)(pcmd->ClipRect.z - pcmd->ClipRect.x),
-                                      (int)(pcmd->ClipRect.w - pcmd->ClipRect.y));
-                Gfx::Draw(PrimitiveGroup(elmOffset, pcmd->ElemCount));
+    // evict the least recently used glyphs
+    while (this->dynamicGlyphs.Size() > this->setup.MaxDynamicGlyphs) {
+        int lruIndex = 0;
+        for (int i = 1; i < this->dynamicGlyphs.Size(); i++) {
+            if (this->dynamicGlyphs.ValueAtIndex(i) < this->dynamicGlyphs.ValueAtIndex(lruIndex)) {
+                lruIndex = i;
             }
-            elmOffset += pcmd->ElemCount;
         }
+        const ImWchar c = this->dynamicGlyphs.KeyAtIndex(lruIndex);
+        this->dynamicGlyphs.Erase(c);
+    }
+
+    // re-bake the atlas in place, this keeps the ImFont objects (and
+    // the pointers handed out by IMUI::Font()) alive, the first
+    // config is ImGui's default font, followed by the setup fonts
+    ImFontAtlas* atlas = ImGui::GetIO().Fonts;
+    o_assert_dbg(atlas->ConfigData.Size == (1 + this->setup.numFonts));
+    for (int i = 0; i < this->setup.numFonts; i++) {
+        atlas->ConfigData[1 + i].GlyphRanges = this->buildDynamicGlyphRanges(i);
+    }
+    const ImTextureID texId = atlas->TexID;
+    atlas->ClearTexData();
+    Gfx::DestroyResources(this->fontTextureLabel);
+    this->textureBytes -= this->fontAtlasBytes;
+    this->createFontTexture();
+    atlas->TexID = texId;
+    this->imagePool.Bind(texId, this->fontTexture);
+    this->dynamicGlyphsDirty = false;
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::setupMeshAndDrawState() {
+    // compact vertices are dequantized by the vertex fetch (uvs are
+    // normalized shorts) and the position scale is folded into the
+    // projection matrix, so both layouts work with the same shaders
+    if (this->setup.CompactVertices) {
+        this->vertexLayout
+            .Add(VertexAttr::Position, VertexFormat::Short2)
+            .Add(VertexAttr::TexCoord0, VertexFormat::Short2N)
+            .Add(VertexAttr::Color0, VertexFormat::UByte4N);
+        this->vertexSize = sizeof(imguiCompactVertex);
+    }
+    else {
+        this->vertexLayout
+            .Add(VertexAttr::Position, VertexFormat::Float2)
+            .Add(VertexAttr::TexCoord0, VertexFormat::Float2)
+            .Add(VertexAttr::Color0, VertexFormat::UByte4N);
+        this->vertexSize = sizeof(ImDrawVert);
+    }
+    o_assert_dbg(this->vertexLayout.ByteSize() == this->vertexSize);
+
+    // the first stream chunk starts small and grows with the UI
+    this->ctx->chunks.Add();
+    this->createChunkMesh(0, this->minChunkVertices, this->minChunkIndices);
+    this->drawState.Mesh[0] = this->ctx->chunks[0].mesh();
+
+    // pipelines are created per render target format when a context
+    // needs them, the font atlas uses the default shader if it's RGBA8
+    this->shaders[DefaultPipeline] = Gfx::CreateResource(IMUIShader::Setup());
+    if (this->setup.SDFFonts) {
+        #if ORYOL_OPENGLES2
+        this->shaders[FontPipeline] = Gfx::CreateResource(IMUIFontSDFFixedShader::Setup());
+        #else
+        this->shaders[FontPipeline] = Gfx::CreateResource(IMUIFontSDFShader::Setup());
+        #endif
+    }
+    else if (this->setup.Alpha8FontAtlas) {
+        this->shaders[FontPipeline] = Gfx::CreateResource(IMUIFontShader::Setup());
+    }
+    else {
+        this->shaders[FontPipeline] = this->shaders[DefaultPipeline];
+    }
+
+    // GPU plots place instanced quads, without instancing support
+    // IMUI::PlotLinesGPU() falls back to ImGui::PlotLines()
+    if (Gfx::QueryFeature(GfxFeature::Instancing)) {
+        this->plotQuadMesh = imguiPlotRenderer::CreateQuadMesh();
+        this->plotShaders[imguiPlotRenderer::Lines] = Gfx::CreateResource(IMUIPlotLineShader::Setup());
+        this->plotShaders[imguiPlotRenderer::Histogram] = Gfx::CreateResource(IMUIPlotBarShader::Setup());
+    }
+    this->ctx->pipelineSet = this->lookupPipelineSet(this->ctx->setup);
+    this->drawState.Pipeline = this->pipelineSets[this->ctx->pipelineSet].pipelines[DefaultPipeline];
+}
+
+//------------------------------------------------------------------------------
+int
+imguiWrapper::lookupPipelineSet(const IMUIContextSetup& ctxSetup) {
+    PixelFormat::Code colorFormat = ctxSetup.ColorFormat;
+    PixelFormat::Code depthFormat = ctxSetup.DepthFormat;
+    int sampleCount = ctxSetup.SampleCount;
+    if (PixelFormat::InvalidPixelFormat == colorFormat) {
+        const DisplayAttrs& dispAttrs = Gfx::DisplayAttrs();
+        colorFormat = dispAttrs.ColorPixelFormat;
+        depthFormat = dispAttrs.DepthPixelFormat;
+        sampleCount = dispAttrs.SampleCount;
+    }
+    for (int i = 0; i < this->pipelineSets.Size(); i++) {
+        const pipelineSet& set = this->pipelineSets[i];
+        if ((set.colorFormat == colorFormat) && (set.depthFormat == depthFormat) && (set.sampleCount == sampleCount)) {
+            return i;
+        }
+    }
+
+    // the pipelines live as long as the wrapper, even if no context uses them anymore
+    Gfx::PushResourceLabel(this->resLabel);
+    pipelineSet& set = this->pipelineSets.Add();
+    set.colorFormat = colorFormat;
+    set.depthFormat = depthFormat;
+    set.sampleCount = sampleCount;
+    set.pipelines[DefaultPipeline] = this->createPipeline(this->shaders[DefaultPipeline], this->vertexLayout, nullptr, colorFormat, depthFormat, sampleCount);
+    if (this->shaders[FontPipeline] != this->shaders[DefaultPipeline]) {
+        set.pipelines[FontPipeline] = this->createPipeline(this->shaders[FontPipeline], this->vertexLayout, nullptr, colorFormat, depthFormat, sampleCount);
+    }
+    else {
+        set.pipelines[FontPipeline] = set.pipelines[DefaultPipeline];
+    }
+    if (this->plotQuadMesh.IsValid()) {
+        const VertexLayout quadLayout = imguiPlotRenderer::QuadLayout();
+        const VertexLayout instLayout = imguiPlotRenderer::InstanceLayout();
+        for (int type = 0; type < imguiPlotRenderer::NumPlotTypes; type++) {
+            set.plotPipelines[type] = this->createPipeline(this->plotShaders[type], quadLayout, &instLayout, colorFormat, depthFormat, sampleCount);
+        }
+    }
+    Gfx::PopResourceLabel();
+    return this->pipelineSets.Size() - 1;
+}
+
+//------------------------------------------------------------------------------
+Id
+imguiWrapper::createPipeline(const Id& shd, const VertexLayout& layout, const VertexLayout* instanceLayout, PixelFormat::Code colorFormat, PixelFormat::Code depthFormat, int sampleCount) {
+    auto ps = PipelineSetup::FromLayoutAndShader(layout, shd);
+    if (instanceLayout) {
+        ps.Layouts[1] = *instanceLayout;
+    }
+    ps.DepthStencilState.DepthWriteEnabled = false;
+    ps.DepthStencilState.DepthCmpFunc = CompareFunc::Always;
+    ps.BlendState.BlendEnabled = true;
+    ps.BlendState.SrcFactorRGB = BlendFactor::SrcAlpha;
+    ps.BlendState.DstFactorRGB = BlendFactor::OneMinusSrcAlpha;
+    ps.BlendState.ColorFormat = colorFormat;
+    ps.BlendState.DepthFormat = depthFormat;
+    ps.BlendState.ColorWriteMask = PixelChannel::RGB;
+    ps.RasterizerState.ScissorTestEnabled = true;
+    ps.RasterizerState.CullFaceEnabled = false;
+    ps.RasterizerState.SampleCount = sampleCount;
+    return Gfx::CreateResource(ps);
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::createChunkMesh(int chunkIndex, int numVertices, int numIndices) {
+    o_assert_dbg((numVertices <= this->maxChunkVertices) && (numIndices <= this->maxChunkIndices));
+    streamChunk& chunk = this->ctx->chunks[chunkIndex];
+    if (chunk.mesh().IsValid()) {
+        Gfx::DestroyResources(chunk.label);
+    }
+    // each chunk gets its own resource label so its meshes can be
+    // destroyed independently from the other IMUI resources, a chunk
+    // has a ring of meshes which are rotated through frame by frame
+    // so that the CPU doesn't overwrite a buffer the GPU still reads
+    const IndexType::Code indexType = sizeof(ImDrawIdx) == 2 ? IndexType::Index16 : IndexType::Index32;
+    MeshSetup meshSetup = MeshSetup::Empty(numVertices, Usage::Stream, indexType, numIndices, Usage::Stream);
+    meshSetup.Layout = this->vertexLayout;
+    if (!this->headless) {
+        chunk.label = Gfx::PushResourceLabel();
+        for (int i = 0; i < this->numStreamBuffers; i++) {
+            chunk.meshes[i] = Gfx::CreateResource(meshSetup);
+            o_assert(chunk.meshes[i].IsValid());
+            o_assert(Gfx::QueryResourceInfo(chunk.meshes[i]).State == ResourceState::Valid);
+        }
+        Gfx::PopResourceLabel();
+    }
+    chunk.curMesh = 0;
+    chunk.vertexCapacity = numVertices;
+    chunk.indexCapacity = numIndices;
+    chunk.highWaterVertices = 0;
+    chunk.highWaterIndices = 0;
+    chunk.idleFrames = 0;
+}
+
+//------------------------------------------------------------------------------
+ImTextureID
+imguiWrapper::AllocImage() {
+    return this->imagePool.Alloc();
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::FreeImage(ImTextureID img) {
+    const auto* image = this->imagePool.Lookup(img);
+    if (image && (image->page >= 0)) {
+        this->imageAtlas.Remove(image->page);
+    }
+    this->imagePool.Free(img);
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::BindImage(ImTextureID img, Id texId) {
+    o_assert_dbg(this->imagePool.IsValid(img) && !this->imagePool.IsBound(img));
+    this->imagePool.Bind(img, texId);
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiWrapper::BindImagePixels(ImTextureID img, const void* rgba8Pixels, int width, int height) {
+    o_assert_dbg(this->imagePool.IsValid(img) && !this->imagePool.IsBound(img));
+    if (!this->imageAtlas.IsValid()) {
+        return false;
+    }
+    int page = 0;
+    ImVec2 uvOffset, uvScale;
+    if (!this->imageAtlas.Add(rgba8Pixels, width, height, page, uvOffset, uvScale)) {
+        return false;
+    }
+    this->imagePool.BindAtlasRegion(img, page, uvOffset, uvScale);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::beginFrameStats() {
+    context& c = *this->ctx;
+    if (c.frameStatsComplete) {
+        c.frameStatsHistory[c.frameStatsHistoryPos] = c.frameStats;
+        c.frameStatsHistoryPos = (c.frameStatsHistoryPos + 1) % MaxFrameStatsHistory;
+        if (c.numFrameStatsHistory < MaxFrameStatsHistory) {
+            c.numFrameStatsHistory++;
+        }
+        c.frameStatsComplete = false;
+    }
+    c.frameStats = IMUIFrameStats();
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::NewFrame(float frameDurationInSeconds) {
+    const TimePoint startTime = Clock::Now();
+    context& c = *this->ctx;
+    this->frameCount++;
+    this->beginFrameStats();
+    c.plots.Reset();
+
+    ImGuiIO& io = ImGui::GetIO();
+    o_assert_dbg(io.UserData == &c);
+    if ((c.setup.Width > 0) && (c.setup.Height > 0)) {
+        io.DisplaySize = ImVec2((float)c.setup.Width, (float)c.setup.Height);
+    }
+    else {
+        DisplayAttrs dispAttrs = Gfx::PassAttrs();
+        o_assert_dbg((dispAttrs.FramebufferWidth > 0) && (dispAttrs.FramebufferHeight > 0));
+        io.DisplaySize = ImVec2((float)dispAttrs.FramebufferWidth, (float)dispAttrs.FramebufferHeight);
+    }
+    io.DeltaTime = frameDurationInSeconds;
+
+    // transfer input, with the event queue all mouse and keyboard
+    // events since the last frame are applied in order
+    c.frameIndex++;
+    if (this->setup.InputEventQueue && !this->inputSubscribed && Input::IsValid()) {
+        this->inputCallbackId = Input::SubscribeEvents(onInputEvent);
+        this->inputSubscribed = true;
+    }
+    if (c.setup.ReceiveInput && Input::IsValid()) {
+        this->pollInput();
+    }
+    if (!c.inputEvents.Empty()) {
+        this->applyInputEvents(c, false);
+    }
+
+    // swap in the fonts from the background bake once they're done,
+    // this must happen outside of an ImGui frame
+    #if ORYOL_HAS_THREADS
+    if (this->pendingFontAtlas && this->fontBakeDone) {
+        this->finishFontBake();
+    }
+    #endif
+
+    // bake glyphs which were typed or registered since the last frame,
+    // this must happen outside of an ImGui frame
+    if (this->setup.DynamicGlyphs) {
+        for (int i = 0; (i < IM_ARRAYSIZE(io.InputCharacters)) && io.InputCharacters[i]; i++) {
+            this->useGlyph(io.InputCharacters[i]);
+        }
+        if (this->dynamicGlyphsDirty) {
+            this->rebuildFontAtlas();
+        }
+    }
+
+    // update idle tracking, contexts without input routing only
+    // update when requested by the app
+    if (c.setup.ReceiveInput) {
+        const inputState curInput = captureInputState();
+        if (curInput.isActive() || !(curInput == c.lastInput)) {
+            c.lastActivityTime = startTime;
+        }
+        c.lastInput = curInput;
+    }
+    if (c.frameStats.NumInputEvents > 0) {
+        c.lastActivityTime = startTime;
+    }
+    if (c.numRequestedFrames > 0) {
+        c.numRequestedFrames--;
+    }
+
+    ImGui::NewFrame();
+    c.frameStats.NewFrameTime = Clock::Since(startTime);
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::pollInput() {
+    ImGuiIO& io = ImGui::GetIO();
+    // with the event queue, mouse and keyboard input arrives through
+    // onInputEvent(), touch input is still polled
+    if (Input::MouseAttached() && !this->inputSubscribed) {
+        io.MousePos.x = Input::MousePosition().x;
+        io.MousePos.y = Input::MousePosition().y;
+        io.MouseWheelH = Input::MouseScroll().x;
+        io.MouseWheel = Input::MouseScroll().y;
+        for (int btn = 0; btn < 3; btn++) {
+            io.MouseDown[btn] = Input::MouseButtonDown((MouseButton::Code)btn)||Input::MouseButtonPressed((MouseButton::Code)btn);
+        }
+    }
+    if (Input::TouchpadAttached()) {
+        if (Input::TouchStarted() || Input::TouchPanning()) {
+            const glm::vec2& touchPos = Input::TouchPosition(0);
+            io.MousePos.x = touchPos.x;
+            io.MousePos.y = touchPos.y;
+            io.MouseDown[0] = true;
+        }
+        else if (Input::TouchEnded() || Input::TouchCancelled()) {
+            const glm::vec2& touchPos = Input::TouchPosition(0);
+            io.MousePos.x = touchPos.x;
+            io.MousePos.y = touchPos.y;
+            io.MouseDown[0] = false;
+        }
+    }
+    if (Input::KeyboardAttached() && !this->inputSubscribed) {
+        const wchar_t* text = Input::Text();
+        while (wchar_t c = *text++) {
+            io.AddInputCharacter((unsigned short)c);
+        }
+        io.KeyCtrl  = Input::KeyPressed(Key::LeftControl) || Input::KeyPressed(Key::RightControl);
+        io.KeyShift = Input::KeyPressed(Key::LeftShift) || Input::KeyPressed(Key::RightShift);
+        io.KeyAlt   = Input::KeyPressed(Key::LeftAlt) || Input::KeyPressed(Key::RightAlt);
+        io.KeySuper = Input::KeyPressed(Key::LeftSuper) || Input::KeyPressed(Key::RightSuper);
+
+        // all keys are forwarded, so that ImGui::IsKeyPressed() works
+        // with any Key::Code, not just the ones in io.KeyMap
+        for (int key = Key::InvalidKey + 1; key < Key::NumKeys; key++) {
+            io.KeysDown[key] = Input::KeyDown((Key::Code)key) || Input::KeyPressed((Key::Code)key);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::onInputEvent(const InputEvent& event) {
+    o_assert_dbg(self);
+    IMUIInputEvent e;
+    switch (event.Type) {
+        case InputEvent::MouseMove:
+            e.EventType = IMUIInputEvent::MouseMove;
+            e.X = event.Position.x;
+            e.Y = event.Position.y;
+            break;
+        case InputEvent::MouseButtonDown:
+        case InputEvent::MouseButtonUp:
+            e.EventType = (InputEvent::MouseButtonDown == event.Type) ? IMUIInputEvent::MouseButtonDown : IMUIInputEvent::MouseButtonUp;
+            e.Code = event.Button;
+            break;
+        case InputEvent::MouseScroll:
+            e.EventType = IMUIInputEvent::MouseWheel;
+            e.X = event.Scrolling.x;
+            e.Y = event.Scrolling.y;
+            break;
+        case InputEvent::KeyDown:
+        case InputEvent::KeyUp:
+            e.EventType = (InputEvent::KeyDown == event.Type) ? IMUIInputEvent::KeyDown : IMUIInputEvent::KeyUp;
+            e.Code = event.KeyCode;
+            break;
+        case InputEvent::WChar:
+            e.EventType = IMUIInputEvent::Char;
+            e.CharCode = event.WCharCode;
+            break;
+        default:
+            // key repeats are generated by ImGui itself
+            return;
+    }
+    e.Time = Clock::Now();
+    for (context* c : self->contexts) {
+        if (c && c->setup.ReceiveInput) {
+            self->queueInputEvent(*c, e);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::InjectInputEvent(const IMUIInputEvent& event) {
+    o_assert_dbg(IMUIInputEvent::InvalidType != event.EventType);
+    IMUIInputEvent e = event;
+    if (0 == e.Time.getRaw()) {
+        e.Time = Clock::Now();
+    }
+    this->queueInputEvent(*this->ctx, e);
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::LatchInput() {
+    if (!this->ctx->inputEvents.Empty()) {
+        this->applyInputEvents(*this->ctx, true);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::queueInputEvent(context& c, const IMUIInputEvent& event) {
+    if (c.inputEvents.Size() >= this->setup.MaxQueuedInputEvents) {
+        c.inputEvents.Erase(0);
+        c.frameStats.NumInputEventsDropped++;
+    }
+    queuedInputEvent& q = c.inputEvents.Add();
+    q.event = event;
+    q.frame = c.frameIndex;
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiWrapper::buttonChangeDeferred(const context& c, int firstEvent, const bool* buttonChanged, const bool* keyChanged) const {
+    // Look ahead through the queued events with the button and key
+    // changes of this frame: true if a mouse button changes a second
+    // time before event processing would stop for another reason.
+    const ImGuiIO& io = ImGui::GetIO();
+    bool buttons[IM_ARRAYSIZE(io.MouseDown)];
+    bool keys[IM_ARRAYSIZE(io.KeysDown)];
+    Memory::Copy(buttonChanged, buttons, sizeof(buttons));
+    Memory::Copy(keyChanged, keys, sizeof(keys));
+    for (int i = firstEvent; i < c.inputEvents.Size(); i++) {
+        const IMUIInputEvent& e = c.inputEvents[i].event;
+        switch (e.EventType) {
+            case IMUIInputEvent::MouseButtonDown:
+            case IMUIInputEvent::MouseButtonUp:
+                if ((e.Code >= 0) && (e.Code < IM_ARRAYSIZE(buttons))) {
+                    if (buttons[e.Code]) {
+                        return true;
+                    }
+                    buttons[e.Code] = true;
+                }
+                break;
+            case IMUIInputEvent::KeyDown:
+            case IMUIInputEvent::KeyUp:
+                if ((e.Code >= 0) && (e.Code < IM_ARRAYSIZE(keys))) {
+                    if (keys[e.Code]) {
+                        return false;
+                    }
+                    keys[e.Code] = true;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::applyInputEvents(context& c, bool latch) {
+    ImGuiIO& io = ImGui::GetIO();
+    o_assert_dbg(io.UserData == &c);
+
+    // ImGui only sees the button and key state once per frame, so
+    // when a button or key changes a second time, the remaining events
+    // wait for the next frame (a fast click takes 2 frames instead of
+    // getting lost), a mouse move which comes before such a second
+    // button change waits as well, so that the deferred change happens
+    // at the right position
+    bool buttonChanged[IM_ARRAYSIZE(io.MouseDown)] = { };
+    bool keyChanged[IM_ARRAYSIZE(io.KeysDown)] = { };
+    bool anyButtonChanged = false;
+    int numChars = 0;
+    while ((numChars < IM_ARRAYSIZE(io.InputCharacters)) && io.InputCharacters[numChars]) {
+        numChars++;
+    }
+    IMUIFrameStats& stats = c.frameStats;
+    int numApplied = 0;
+    for (; numApplied < c.inputEvents.Size(); numApplied++) {
+        const queuedInputEvent& q = c.inputEvents[numApplied];
+        const IMUIInputEvent& e = q.event;
+        if (latch && (IMUIInputEvent::MouseMove != e.EventType)) {
+            break;
+        }
+        bool deferred = false;
+        switch (e.EventType) {
+            case IMUIInputEvent::MouseMove:
+                if (anyButtonChanged && this->buttonChangeDeferred(c, numApplied + 1, buttonChanged, keyChanged)) {
+                    deferred = true;
+                }
+                else {
+                    io.MousePos = ImVec2(e.X, e.Y);
+                }
+                break;
+            case IMUIInputEvent::MouseButtonDown:
+            case IMUIInputEvent::MouseButtonUp:
+                if ((e.Code >= 0) && (e.Code < IM_ARRAYSIZE(io.MouseDown))) {
+                    if (buttonChanged[e.Code]) {
+                        deferred = true;
+                    }
+                    else {
+                        io.MouseDown[e.Code] = IMUIInputEvent::MouseButtonDown == e.EventType;
+                        buttonChanged[e.Code] = true;
+                        anyButtonChanged = true;
+                    }
+                }
+                break;
+            case IMUIInputEvent::MouseWheel:
+                io.MouseWheelH += e.X;
+                io.MouseWheel += e.Y;
+                break;
+            case IMUIInputEvent::KeyDown:
+            case IMUIInputEvent::KeyUp:
+                if ((e.Code >= 0) && (e.Code < IM_ARRAYSIZE(io.KeysDown))) {
+                    if (keyChanged[e.Code]) {
+                        deferred = true;
+                    }
+                    else {
+                        io.KeysDown[e.Code] = IMUIInputEvent::KeyDown == e.EventType;
+                        keyChanged[e.Code] = true;
+                    }
+                }
+                break;
+            case IMUIInputEvent::Char:
+                // io.InputCharacters is zero-terminated
+                if (numChars >= (IM_ARRAYSIZE(io.InputCharacters) - 1)) {
+                    deferred = true;
+                }
+                else {
+                    io.AddInputCharacter((ImWchar)e.CharCode);
+                    numChars++;
+                }
+                break;
+            default:
+                break;
+        }
+        if (deferred) {
+            break;
+        }
+        const int latencyFrames = c.frameIndex - q.frame;
+        if (latencyFrames > stats.InputLatencyFrames) {
+            stats.InputLatencyFrames = latencyFrames;
+        }
+        if ((0 == stats.NumInputEvents) || (e.Time < c.oldestInputTime)) {
+            c.oldestInputTime = e.Time;
+        }
+        stats.NumInputEvents++;
+    }
+
+    // remove the applied events from the queue
+    const int numLeft = c.inputEvents.Size() - numApplied;
+    for (int i = 0; i < numLeft; i++) {
+        c.inputEvents[i] = c.inputEvents[numApplied + i];
+    }
+    while (c.inputEvents.Size() > numLeft) {
+        c.inputEvents.PopBack();
+    }
+    if (!latch) {
+        stats.NumInputEventsDeferred = numLeft;
+        io.KeyCtrl  = io.KeysDown[Key::LeftControl] || io.KeysDown[Key::RightControl];
+        io.KeyShift = io.KeysDown[Key::LeftShift] || io.KeysDown[Key::RightShift];
+        io.KeyAlt   = io.KeysDown[Key::LeftAlt] || io.KeysDown[Key::RightAlt];
+        io.KeySuper = io.KeysDown[Key::LeftSuper] || io.KeysDown[Key::RightSuper];
+    }
+}
+
+//------------------------------------------------------------------------------
+imguiWrapper::inputState
+imguiWrapper::captureInputState() {
+    inputState state;
+    if (Input::IsValid()) {
+        if (Input::MouseAttached()) {
+            state.mousePos = Input::MousePosition();
+            state.mouseScroll = Input::MouseScroll();
+            for (int btn = 0; btn < 3; btn++) {
+                if (Input::MouseButtonDown((MouseButton::Code)btn) || Input::MouseButtonPressed((MouseButton::Code)btn)) {
+                    state.mouseButtons |= (1 << btn);
+                }
+            }
+        }
+        if (Input::TouchpadAttached()) {
+            state.touch = Input::TouchStarted() || Input::TouchPanning() || Input::TouchEnded() || Input::TouchCancelled();
+        }
+        if (Input::KeyboardAttached()) {
+            state.text = 0 != Input::Text()[0];
+            for (int i = 0; i < int(sizeof(imguiKeys) / sizeof(imguiKeys[0])); i++) {
+                if (Input::KeyDown(imguiKeys[i]) || Input::KeyPressed(imguiKeys[i])) {
+                    state.keys |= (1 << i);
+                }
+            }
+            for (int i = 0; i < int(sizeof(modifierKeys) / sizeof(modifierKeys[0])); i++) {
+                if (Input::KeyPressed(modifierKeys[i])) {
+                    state.modifiers |= (1 << i);
+                }
+            }
+        }
+    }
+    return state;
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiWrapper::inputState::isActive() const {
+    // held buttons and keys count as activity because ImGui
+    // may act on them every frame (dragging, key repeat)
+    return (0 != this->mouseButtons) || (0 != this->keys) || this->text || this->touch ||
+           (0.0f != this->mouseScroll.x) || (0.0f != this->mouseScroll.y);
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiWrapper::inputState::operator==(const inputState& rhs) const {
+    return (this->mousePos == rhs.mousePos) &&
+           (this->mouseButtons == rhs.mouseButtons) &&
+           (this->keys == rhs.keys) &&
+           (this->modifiers == rhs.modifiers);
+}
+
+//------------------------------------------------------------------------------
+float
+imguiWrapper::SecondsToNextUpdate() const {
+    if ((this->ctx->numRequestedFrames > 0) || !this->ctx->inputEvents.Empty() || ImGui::IsAnyItemActive()) {
+        return 0.0f;
+    }
+    if (this->ctx->setup.ReceiveInput) {
+        const inputState curInput = captureInputState();
+        if (curInput.isActive() || !(curInput == this->ctx->lastInput)) {
+            return 0.0f;
+        }
+    }
+    // keep updating for a little while after the last input, so
+    // that hover highlights and similar follow-up changes settle
+    float seconds = this->setup.IdleDelaySeconds - float(Clock::Since(this->ctx->lastActivityTime).AsSeconds());
+    if (seconds > 0.0f) {
+        return seconds;
+    }
+    // a focused text field needs regular updates for the blinking cursor
+    if (ImGui::GetIO().WantTextInput) {
+        return CursorBlinkSeconds;
+    }
+    return IdleSeconds;
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiWrapper::NeedsUpdate() const {
+    return this->SecondsToNextUpdate() <= 0.0f;
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::RequestUpdate(int numFrames) {
+    o_assert_dbg(numFrames > 0);
+    if (numFrames > this->ctx->numRequestedFrames) {
+        this->ctx->numRequestedFrames = numFrames;
+    }
+}
+
+//------------------------------------------------------------------------------
+const IMUIFrameStats&
+imguiWrapper::FrameStats() const {
+    return this->ctx->frameStats;
+}
+
+//------------------------------------------------------------------------------
+const IMUIFontAtlasInfo&
+imguiWrapper::FontAtlasInfo() const {
+    return this->fontAtlasInfo;
+}
+
+//------------------------------------------------------------------------------
+int
+imguiWrapper::NumFrameStatsHistory() const {
+    return this->ctx->numFrameStatsHistory;
+}
+
+//------------------------------------------------------------------------------
+const IMUIFrameStats&
+imguiWrapper::FrameStatsHistory(int framesAgo) const {
+    o_assert_dbg((framesAgo >= 0) && (framesAgo < this->ctx->numFrameStatsHistory));
+    const int index = (this->ctx->frameStatsHistoryPos - 1 - framesAgo + MaxFrameStatsHistory) % MaxFrameStatsHistory;
+    return this->ctx->frameStatsHistory[index];
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::ShowStatsWindow(bool* open) {
+    ImGui::SetNextWindowSize(ImVec2(360, 0), ImGuiCond_FirstUseEver);
+    if (ImGui::Begin("IMUI Stats", open)) {
+        const int num = this->ctx->numFrameStatsHistory;
+        if (0 == num) {
+            ImGui::Text("no frame rendered yet");
+        }
+        else {
+            const IMUIFrameStats& s = this->FrameStatsHistory(0);
+            ImGui::Text("cmd lists: %d (%d dropped), chunks: %d", s.NumCmdLists, s.NumCmdListsDropped, s.NumChunks);
+            ImGui::Text("vertices: %d, indices: %d", s.NumVertices, s.NumIndices);
+            ImGui::Text("draws: %d (%d merged), draw cmds: %d", s.NumDraws, s.NumDrawsSaved, s.NumDrawCmds);
+            ImGui::Text("draw states: %d, textures: %d (%d saved)", s.NumApplyDrawState, s.NumTextureChanges, s.NumTextureSwitchesSaved);
+            ImGui::Text("uniforms: %d, scissors: %d (%d saved)", s.NumApplyUniformBlock, s.NumApplyScissorRect, s.NumScissorRectsSaved);
+            ImGui::Text("copied: %d bytes, uploaded: %d bytes%s", s.BytesCopied, s.BytesUploaded, s.UploadSkipped ? " (skipped)" : "");
+            ImGui::Text("direct uploads: %d of %d chunks", s.NumDirectUploads, s.NumChunks);
+            ImGui::Text("new frame: %.3f ms, render: %.3f ms", s.NewFrameTime.AsMilliSeconds(), s.RenderTime.AsMilliSeconds());
+            if ((s.NumInputEvents > 0) || (s.NumInputEventsDeferred > 0) || (s.NumInputEventsDropped > 0)) {
+                ImGui::Text("input events: %d (%d deferred, %d dropped), latency: %d frames, %.3f ms",
+                    s.NumInputEvents, s.NumInputEventsDeferred, s.NumInputEventsDropped, s.InputLatencyFrames, s.InputLatency.AsMilliSeconds());
+            }
+            if (s.NumPlots > 0) {
+                ImGui::Text("gpu plots: %d, samples: %d, %d bytes, %.3f ms", s.NumPlots, s.NumPlotSamples, s.PlotBytes, s.PlotTime.AsMilliSeconds());
+            }
+
+            // the graphs run from the oldest to the most recent frame
+            struct plot {
+                const imguiWrapper* wrapper;
+                float (*value)(const IMUIFrameStats& s);
+                static float get(void* data, int index) {
+                    const plot* p = (const plot*) data;
+                    return p->value(p->wrapper->FrameStatsHistory(p->wrapper->ctx->numFrameStatsHistory - 1 - index));
+                }
+            };
+            const ImVec2 graphSize(0, 40);
+            plot renderTime = { this, [](const IMUIFrameStats& s) { return float((s.NewFrameTime + s.RenderTime).AsMilliSeconds()); } };
+            ImGui::PlotLines("cpu ms", plot::get, &renderTime, num, 0, nullptr, 0.0f, FLT_MAX, graphSize);
+            plot draws = { this, [](const IMUIFrameStats& s) { return float(s.NumDraws); } };
+            ImGui::PlotLines("draws", plot::get, &draws, num, 0, nullptr, 0.0f, FLT_MAX, graphSize);
+            plot vertices = { this, [](const IMUIFrameStats& s) { return float(s.NumVertices); } };
+            ImGui::PlotLines("vertices", plot::get, &vertices, num, 0, nullptr, 0.0f, FLT_MAX, graphSize);
+            plot uploaded = { this, [](const IMUIFrameStats& s) { return float(s.BytesUploaded) / 1024.0f; } };
+            ImGui::PlotLines("upload KB", plot::get, &uploaded, num, 0, nullptr, 0.0f, FLT_MAX, graphSize);
+        }
+    }
+    ImGui::End();
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::PlotGPU(imguiPlotRenderer::plotType type, const char* label, const float* values, int count, float scaleMin, float scaleMax, ImVec2 size) {
+    const bool isLines = imguiPlotRenderer::Lines == type;
+    if (!this->plotQuadMesh.IsValid() || (count < (isLines ? 2 : 1))) {
+        if (isLines) {
+            ImGui::PlotLines(label, values, count, 0, nullptr, scaleMin, scaleMax, size);
+        }
+        else {
+            ImGui::PlotHistogram(label, values, count, 0, nullptr, scaleMin, scaleMax, size);
+        }
+        return;
+    }
+    const TimePoint startTime = Clock::Now();
+
+    // same layout as ImGui::PlotLines(): a frame, and the label to the right
+    const ImGuiStyle& style = ImGui::GetStyle();
+    const char* labelEnd = ImGui::FindRenderedTextEnd(label);
+    const ImVec2 labelSize = ImGui::CalcTextSize(label, labelEnd);
+    if (size.x == 0.0f) {
+        size.x = ImGui::CalcItemWidth();
+    }
+    if (size.y == 0.0f) {
+        size.y = labelSize.y + style.FramePadding.y * 2.0f;
+    }
+    const ImVec2 pos = ImGui::GetCursorScreenPos();
+    ImGui::Dummy(size);
+    if (ImGui::IsItemVisible()) {
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        const ImVec2 maxPos(pos.x + size.x, pos.y + size.y);
+        drawList->AddRectFilled(pos, maxPos, ImGui::GetColorU32(ImGuiCol_FrameBg), style.FrameRounding);
+        const ImVec4 rect(pos.x + style.FramePadding.x, pos.y + style.FramePadding.y,
+                          maxPos.x - style.FramePadding.x, maxPos.y - style.FramePadding.y);
+        const ImVec4 color = ImGui::ColorConvertU32ToFloat4(ImGui::GetColorU32(isLines ? ImGuiCol_PlotLines : ImGuiCol_PlotHistogram));
+        const int plotIndex = this->ctx->plots.Add(type, values, count, scaleMin, scaleMax, rect, color);
+        drawList->AddCallback(plotCallback, (void*)intptr_t(plotIndex));
+        this->ctx->frameStats.NumPlots++;
+        this->ctx->frameStats.NumPlotSamples += count;
+    }
+    if (labelEnd != label) {
+        ImGui::SameLine(0.0f, style.ItemInnerSpacing.x);
+        ImGui::TextUnformatted(label, labelEnd);
+    }
+    this->ctx->frameStats.PlotTime += Clock::Since(startTime);
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::plotCallback(const ImDrawList* /*cmdList*/, const ImDrawCmd* cmd) {
+    o_assert_dbg(self && self->ctx);
+    const imguiPlotRenderer& plots = self->ctx->plots;
+    const int plotIndex = int(intptr_t(cmd->UserCallbackData));
+    if (plotIndex < plots.NumPlots()) {
+        const imguiPlotRenderer::plotType type = plots.Type(plotIndex);
+        const pipelineSet& pipelines = self->pipelineSets[self->ctx->pipelineSet];
+        plots.Draw(plotIndex, self->plotQuadMesh, pipelines.plotPipelines[type], cmd->ClipRect);
+        self->ctx->frameStats.NumDraws++;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::setupStaging() {
+    const IMUISetup& s = this->setup;
+    o_assert_dbg((s.NumStreamBuffers > 0) && (s.NumStreamBuffers <= MaxStreamBuffers));
+    this->numStreamBuffers = s.NumStreamBuffers;
+    o_assert_dbg((s.InitialVertexCapacity > 0) && (s.InitialIndexCapacity > 0));
+    o_assert_dbg((s.InitialVertexCapacity <= s.MaxVertexCapacity) && (s.InitialIndexCapacity <= s.MaxIndexCapacity));
+    this->maxChunkVertices = s.MaxVertexCapacity < MaxNumVertices ? s.MaxVertexCapacity : MaxNumVertices;
+    this->maxChunkIndices = s.MaxIndexCapacity < MaxNumIndices ? s.MaxIndexCapacity : MaxNumIndices;
+    if (s.StagingArena) {
+        // a user-provided arena is split into a vertex and index area
+        // with the same vertex-to-index ratio as the max capacities,
+        // and the max chunk size is clamped to what fits into the arena
+        o_assert_dbg((s.StagingArenaSize > 0) && ((intptr_t(s.StagingArena) & 3) == 0));
+        const int bytesPerVertex = int(sizeof(ImDrawVert) + (this->maxChunkIndices / this->maxChunkVertices) * sizeof(ImDrawIdx));
+        int numVertices = s.StagingArenaSize / bytesPerVertex;
+        if (numVertices > this->maxChunkVertices) {
+            numVertices = this->maxChunkVertices;
+        }
+        const int numIndices = int((s.StagingArenaSize - numVertices * sizeof(ImDrawVert)) / sizeof(ImDrawIdx));
+        this->maxChunkVertices = numVertices;
+        this->maxChunkIndices = numIndices < this->maxChunkIndices ? numIndices : this->maxChunkIndices;
+        this->vertexData = (ImDrawVert*) s.StagingArena;
+        this->indexData = (ImDrawIdx*) (((uint8_t*)s.StagingArena) + numVertices * sizeof(ImDrawVert));
+        this->stagingVertexCapacity = this->maxChunkVertices;
+        this->stagingIndexCapacity = this->maxChunkIndices;
+        this->stagingInArena = true;
+    }
+    this->minChunkVertices = s.InitialVertexCapacity < this->maxChunkVertices ? s.InitialVertexCapacity : this->maxChunkVertices;
+    this->minChunkIndices = s.InitialIndexCapacity < this->maxChunkIndices ? s.InitialIndexCapacity : this->maxChunkIndices;
+    o_assert((this->minChunkVertices > 0) && (this->minChunkIndices > 0));
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::resizeStaging(int numVertices, int numIndices) {
+    if (this->stagingInArena) {
+        o_assert_dbg((numVertices <= this->stagingVertexCapacity) && (numIndices <= this->stagingIndexCapacity));
+        return;
+    }
+    // staging content doesn't need to be preserved, it is
+    // completely overwritten for each chunk
+    if (numVertices != this->stagingVertexCapacity) {
+        if (this->vertexData) {
+            Memory::Free(this->vertexData);
+        }
+        this->vertexData = (ImDrawVert*) Memory::Alloc(numVertices * sizeof(ImDrawVert));
+        this->stagingVertexCapacity = numVertices;
+    }
+    if (numIndices != this->stagingIndexCapacity) {
+        if (this->indexData) {
+            Memory::Free(this->indexData);
+        }
+        this->indexData = (ImDrawIdx*) Memory::Alloc(numIndices * sizeof(ImDrawIdx));
+        this->stagingIndexCapacity = numIndices;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::discardStaging() {
+    if (!this->stagingInArena) {
+        if (this->vertexData) {
+            Memory::Free(this->vertexData);
+        }
+        if (this->indexData) {
+            Memory::Free(this->indexData);
+        }
+    }
+    this->vertexData = nullptr;
+    this->indexData = nullptr;
+    this->stagingVertexCapacity = 0;
+    this->stagingIndexCapacity = 0;
+    this->stagingInArena = false;
+}
+
+//------------------------------------------------------------------------------
+IMUIMemoryUsage
+imguiWrapper::MemoryUsage() const {
+    IMUIMemoryUsage usage;
+    usage.StagingBytes = this->stagingVertexCapacity * sizeof(ImDrawVert) + this->stagingIndexCapacity * sizeof(ImDrawIdx);
+    for (const context* c : this->contexts) {
+        if (c) {
+            for (const auto& chunk : c->chunks) {
+                usage.StreamMeshBytes += this->numStreamBuffers * (chunk.vertexCapacity * this->vertexSize + chunk.indexCapacity * sizeof(ImDrawIdx));
+            }
+            usage.StreamMeshBytes += c->plots.Bytes();
+        }
+    }
+    usage.TextureBytes = this->textureBytes;
+    usage.FontAtlasBytes = this->fontAtlasBytes;
+    if (this->imageAtlas.IsValid()) {
+        usage.ImageAtlasBytes = this->imageAtlas.Bytes();
+    }
+    return usage;
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiWrapper::fitsIntoChunk(const ImDrawList* cmdList) const {
+    return (cmdList->VtxBuffer.size() <= this->maxChunkVertices) && (cmdList->IdxBuffer.size() <= this->maxChunkIndices);
+}
+
+//------------------------------------------------------------------------------
+int
+imguiWrapper::assignChunks(const ImDrawData* drawData) {
+    // distribute the draw lists in order over as many stream chunks
+    // as needed, a chunk is full when the next draw list would
+    // overflow its max vertex or index count
+    int numChunks = 0;
+    streamChunk* chunk = nullptr;
+    bool directChunk = false;
+    for (int cmdListIndex = 0; cmdListIndex < drawData->CmdListsCount; cmdListIndex++) {
+        const ImDrawList* cmd_list = drawData->CmdLists[cmdListIndex];
+        if (!this->fitsIntoChunk(cmd_list)) {
+            // this draw list can never be rendered, skip it
+            this->ctx->frameStats.NumCmdListsDropped++;
+            if (chunk) {
+                chunk->numCmdLists++;
+            }
+            continue;
+        }
+        const int cmdListNumVertices = cmd_list->VtxBuffer.size();
+        const int cmdListNumIndices = cmd_list->IdxBuffer.size();
+        // with ZeroCopyUpload big draw lists get a chunk of their own
+        // (uploaded straight from the draw list), small draw lists are
+        // still merged into shared chunks
+        const bool direct = this->setup.ZeroCopyUpload && (cmdListNumVertices >= this->setup.ZeroCopyMinVertices);
+        if ((nullptr == chunk) ||
+            (direct && (chunk->numIndices > 0)) ||
+            (directChunk && (cmdListNumIndices > 0)) ||
+            ((chunk->numVertices + cmdListNumVertices) > this->maxChunkVertices) ||
+            ((chunk->numIndices + cmdListNumIndices) > this->maxChunkIndices)) {
+            if (numChunks == this->ctx->chunks.Size()) {
+                this->ctx->chunks.Add();
+            }
+            chunk = &this->ctx->chunks[numChunks++];
+            chunk->firstCmdList = cmdListIndex;
+            chunk->numCmdLists = 0;
+            chunk->numVertices = 0;
+            chunk->numIndices = 0;
+            directChunk = false;
+        }
+        directChunk |= direct;
+        chunk->numCmdLists++;
+        this->ctx->frameStats.NumCmdLists++;
+        chunk->numVertices += cmdListNumVertices;
+        chunk->numIndices += cmdListNumIndices;
+    }
+    return numChunks;
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::updateChunkCapacities(int numUsedChunks) {
+    for (int chunkIndex = this->ctx->chunks.Size() - 1; chunkIndex >= 0; chunkIndex--) {
+        streamChunk& chunk = this->ctx->chunks[chunkIndex];
+        if (chunkIndex >= numUsedChunks) {
+            chunk.numCmdLists = 0;
+            chunk.numVertices = 0;
+            chunk.numIndices = 0;
+            // chunks are filled front to back, so unused chunks are
+            // always at the end, they are dropped after being idle for a
+            // while no matter how small they are (the first chunk stays)
+            if (chunkIndex > 0) {
+                if ((++chunk.idleFrames >= this->setup.StreamIdleFrames) && (chunkIndex == this->ctx->chunks.Size() - 1)) {
+                    if (chunk.mesh().IsValid()) {
+                        Gfx::DestroyResources(chunk.label);
+                    }
+                    this->ctx->chunks.Erase(chunkIndex);
+                }
+                continue;
+            }
+        }
+        // grow immediately if this frame doesn't fit
+        if ((chunk.numVertices > chunk.vertexCapacity) || (chunk.numIndices > chunk.indexCapacity)) {
+            this->createChunkMesh(chunkIndex,
+                roundUpCapacity(chunk.numVertices, this->minChunkVertices, this->maxChunkVertices),
+                roundUpCapacity(chunk.numIndices, this->minChunkIndices, this->maxChunkIndices));
+        }
+        // shrink after the chunk has been oversized for a while
+        if ((roundUpCapacity(chunk.numVertices, this->minChunkVertices, this->maxChunkVertices) < chunk.vertexCapacity) ||
+            (roundUpCapacity(chunk.numIndices, this->minChunkIndices, this->maxChunkIndices) < chunk.indexCapacity)) {
+            if (chunk.numVertices > chunk.highWaterVertices) {
+                chunk.highWaterVertices = chunk.numVertices;
+            }
+            if (chunk.numIndices > chunk.highWaterIndices) {
+                chunk.highWaterIndices = chunk.numIndices;
+            }
+            if (++chunk.idleFrames >= this->setup.StreamIdleFrames) {
+                this->createChunkMesh(chunkIndex,
+                    roundUpCapacity(chunk.highWaterVertices, this->minChunkVertices, this->maxChunkVertices),
+                    roundUpCapacity(chunk.highWaterIndices, this->minChunkIndices, this->maxChunkIndices));
+            }
+        }
+        else {
+            chunk.highWaterVertices = 0;
+            chunk.highWaterIndices = 0;
+            chunk.idleFrames = 0;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::imguiRenderDrawLists(ImDrawData* draw_data) {
+    o_assert_dbg(self);
+    o_assert_dbg(draw_data);
+
+    // ImGui::Render() may be called for any context, not just the one
+    // which was made current through IMUI, that context is only
+    // current while its draw lists are rendered
+    context* prevCtx = self->ctx;
+    self->ctx = (context*) ImGui::GetIO().UserData;
+    o_assert_dbg(self->ctx);
+    self->renderDrawData(draw_data);
+    self->ctx = prevCtx;
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::renderDrawData(ImDrawData* draw_data) {
+    IMUIFrameStats& stats = this->ctx->frameStats;
+    this->ctx->frameStatsComplete = true;
+    if (stats.NumInputEvents > 0) {
+        stats.InputLatency = Clock::Since(this->ctx->oldestInputTime);
+    }
+    if (this->capture.IsWriting() && (this->ctx == this->captureContext)) {
+        this->capture.WriteFrame(draw_data, ImGui::GetIO().DisplaySize, this->fontAtlas->TexID);
+    }
+    if (draw_data->CmdListsCount == 0) {
+        return;
+    }
+    const TimePoint startTime = Clock::Now();
+
+    // images added to the image atlas since the last frame
+    if (this->imageAtlas.IsValid()) {
+        this->imageAtlas.Update();
+    }
+
+    // if the geometry is identical to the last frame, the stream
+    // meshes still contain the right data and the upload can be
+    // skipped (textures and clip rects only affect the draw calls
+    // which are rebuilt each frame anyway)
+    bool skipUpload = false;
+    if (this->setup.RetainUnchangedFrames) {
+        const uint64_t hash = hashDrawData(draw_data);
+        skipUpload = this->ctx->geometryHashValid && (hash == this->ctx->geometryHash);
+        this->ctx->geometryHash = hash;
+        this->ctx->geometryHashValid = true;
+    }
+    stats.UploadSkipped = skipUpload;
+
+    // if the draw lists don't fit into a single stream mesh, they
+    // spill over into additional stream meshes
+    const int numChunks = this->assignChunks(draw_data);
+    stats.NumChunks = numChunks;
+    for (int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++) {
+        stats.NumVertices += this->ctx->chunks[chunkIndex].numVertices;
+        stats.NumIndices += this->ctx->chunks[chunkIndex].numIndices;
+    }
+    if (!skipUpload) {
+        this->uploadChunks(draw_data, numChunks);
+    }
+
+    // plot samples must be uploaded before the first draw call
+    if (this->ctx->plots.NumPlots() > 0) {
+        const TimePoint plotStartTime = Clock::Now();
+        const int plotBytes = this->ctx->plots.Upload();
+        stats.PlotBytes += plotBytes;
+        stats.BytesUploaded += plotBytes;
+        stats.PlotTime += Clock::Since(plotStartTime);
+    }
+
+    // merge compatible draw commands into batches and draw them
+    this->buildBatches(draw_data, numChunks);
+    this->drawBatches();
+    stats.RenderTime = Clock::Since(startTime);
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiWrapper::BeginCapture(const char* path, bool delta) {
+    o_assert_dbg(!this->capture.IsWriting() && !this->capture.IsReading());
+    if (this->capture.BeginWrite(path, delta)) {
+        this->captureContext = this->ctx;
+        return true;
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::EndCapture() {
+    o_assert_dbg(this->capture.IsWriting());
+    this->capture.EndWrite();
+    this->captureContext = nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiWrapper::IsCapturing() const {
+    return this->capture.IsWriting();
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiWrapper::BeginReplay(const char* path) {
+    o_assert_dbg(!this->capture.IsWriting() && !this->capture.IsReading());
+    if (!this->capture.BeginRead(path)) {
+        return false;
+    }
+    // the replay context renders into the same pass as the current context
+    IMUIContextSetup replaySetup = this->ctx->setup;
+    replaySetup.ReceiveInput = false;
+    this->replayContext = this->createContext(replaySetup);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool
+imguiWrapper::ReplayFrame() {
+    o_assert_dbg(this->capture.IsReading() && (InvalidIndex != this->replayContext));
+
+    // the frame goes through the regular render path, but with the
+    // replay context's stream meshes, so the app may render its own
+    // UI in the same frame without a second update of the same mesh
+    context* prevCtx = this->ctx;
+    ImGuiContext* prevImguiContext = ImGui::GetCurrentContext();
+    this->ctx = this->contexts[this->replayContext];
+    ImGui::SetCurrentContext(this->ctx->imguiContext);
+    this->beginFrameStats();
+    ImVec2 displaySize;
+    const bool frameRead = this->capture.ReadFrame(displaySize, this->fontAtlas->TexID);
+    if (frameRead) {
+        ImGui::GetIO().DisplaySize = displaySize;
+        this->renderDrawData(this->capture.DrawData());
+    }
+    this->ctx = prevCtx;
+    ImGui::SetCurrentContext(prevImguiContext);
+    return frameRead;
+}
+
+//------------------------------------------------------------------------------
+const IMUIFrameStats&
+imguiWrapper::ReplayFrameStats() const {
+    o_assert_dbg(InvalidIndex != this->replayContext);
+    return this->contexts[this->replayContext]->frameStats;
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::EndReplay() {
+    o_assert_dbg(this->capture.IsReading());
+    this->capture.EndRead();
+    this->destroyContext(this->replayContext);
+    this->replayContext = InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+uint64_t
+imguiWrapper::hashDrawData(const ImDrawData* drawData) {
+    uint64_t hash = uint64_t(drawData->CmdListsCount);
+    for (int cmdListIndex = 0; cmdListIndex < drawData->CmdListsCount; cmdListIndex++) {
+        const ImDrawList* cmd_list = drawData->CmdLists[cmdListIndex];
+        hash = imguiKernels::Hash(cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.size() * sizeof(ImDrawVert), hash);
+        hash = imguiKernels::Hash(cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.size() * sizeof(ImDrawIdx), hash);
+        // atlased images have their uvs rewritten, so the uploaded
+        // vertices also depend on the image handles
+        for (const ImDrawCmd& cmd : cmd_list->CmdBuffer) {
+            hash = imguiKernels::Hash(&cmd.TextureId, sizeof(cmd.TextureId), hash);
+        }
+    }
+    return hash;
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::uploadChunks(const ImDrawData* drawData, int numChunks) {
+    IMUIFrameStats& stats = this->ctx->frameStats;
+    this->updateChunkCapacities(numChunks);
+
+    // copy vertices and indices of each chunk into the staging
+    // buffers and upload them into the chunk's stream mesh
+    bool stagingResized = false;
+    for (int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++) {
+        streamChunk& chunk = this->ctx->chunks[chunkIndex];
+
+        // a chunk with a single draw list needs no index rebasing, if
+        // the vertices also don't need to be converted it can be
+        // uploaded straight from the draw list
+        if (const ImDrawList* cmd_list = this->directUploadList(drawData, chunkIndex)) {
+            chunk.curMesh = (chunk.curMesh + 1) % this->numStreamBuffers;
+            Gfx::UpdateVertices(chunk.mesh(), cmd_list->VtxBuffer.Data, chunk.numVertices * sizeof(ImDrawVert));
+            Gfx::UpdateIndices(chunk.mesh(), cmd_list->IdxBuffer.Data, chunk.numIndices * sizeof(ImDrawIdx));
+            stats.BytesUploaded += chunk.numVertices * sizeof(ImDrawVert) + chunk.numIndices * sizeof(ImDrawIdx);
+            stats.NumDirectUploads++;
+            continue;
+        }
+
+        // the staging buffers follow the capacity of the biggest chunk,
+        // and are only allocated once a chunk actually needs them
+        if (!stagingResized) {
+            int maxVertices = 0;
+            int maxIndices = 0;
+            for (const auto& c : this->ctx->chunks) {
+                maxVertices = c.vertexCapacity > maxVertices ? c.vertexCapacity : maxVertices;
+                maxIndices = c.indexCapacity > maxIndices ? c.indexCapacity : maxIndices;
+            }
+            this->resizeStaging(maxVertices, maxIndices);
+            stagingResized = true;
+        }
+        this->assembleChunk(drawData, chunkIndex);
+        if (chunk.numIndices > 0) {
+            chunk.curMesh = (chunk.curMesh + 1) % this->numStreamBuffers;
+            Gfx::UpdateVertices(chunk.mesh(), this->vertexData, chunk.numVertices * this->vertexSize);
+            Gfx::UpdateIndices(chunk.mesh(), this->indexData, chunk.numIndices * sizeof(ImDrawIdx));
+            stats.BytesUploaded += chunk.numVertices * this->vertexSize + chunk.numIndices * sizeof(ImDrawIdx);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::assembleChunk(const ImDrawData* drawData, int chunkIndex) {
+    IMUIFrameStats& stats = this->ctx->frameStats;
+    const streamChunk& chunk = this->ctx->chunks[chunkIndex];
+    this->buildAssemblyJobs(drawData, chunkIndex);
+    if ((chunk.numVertices >= this->setup.ParallelAssemblyMinVertices) && (this->workerPool.NumWorkers() > 0)) {
+        this->workerPool.ParallelFor(this->assemblyJobs.Size(), [this](int jobIndex) {
+            runAssemblyJob(this->assemblyJobs[jobIndex]);
+        });
+    }
+    else {
+        for (auto& job : this->assemblyJobs) {
+            runAssemblyJob(job);
+        }
+    }
+    for (const auto& job : this->assemblyJobs) {
+        stats.RebaseTime += job.rebaseTime;
+    }
+    if (this->imageAtlas.IsValid()) {
+        this->remapAtlasUVs(drawData, chunkIndex);
+    }
+    stats.BytesCopied += chunk.numVertices * this->vertexSize + chunk.numIndices * sizeof(ImDrawIdx);
+}
+
+//------------------------------------------------------------------------------
+const ImDrawList*
+imguiWrapper::directUploadList(const ImDrawData* drawData, int chunkIndex) const {
+    if (this->setup.CompactVertices) {
+        return nullptr;
+    }
+    const streamChunk& chunk = this->ctx->chunks[chunkIndex];
+    if (0 == chunk.numIndices) {
+        return nullptr;
+    }
+    const ImDrawList* result = nullptr;
+    const int endCmdList = chunk.firstCmdList + chunk.numCmdLists;
+    for (int cmdListIndex = chunk.firstCmdList; cmdListIndex < endCmdList; cmdListIndex++) {
+        const ImDrawList* cmd_list = drawData->CmdLists[cmdListIndex];
+        if (!this->fitsIntoChunk(cmd_list) || (cmd_list->VtxBuffer.empty() && cmd_list->IdxBuffer.empty())) {
+            continue;
+        }
+        if (result) {
+            // more than one non-empty draw list
+            return nullptr;
+        }
+        result = cmd_list;
+    }
+    // the uvs of atlased images must be remapped in a copy
+    if (result && this->imageAtlas.IsValid()) {
+        for (const ImDrawCmd& cmd : result->CmdBuffer) {
+            const auto* image = cmd.UserCallback ? nullptr : this->imagePool.Lookup(cmd.TextureId);
+            if (image && (image->page >= 0)) {
+                return nullptr;
+            }
+        }
+    }
+    return result;
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::buildAssemblyJobs(const ImDrawData* drawData, int chunkIndex) {
+    // A prefix sum over the draw list sizes gives each draw list its
+    // own destination range in the staging buffers. Big draw lists
+    // are split into several jobs so that a single huge window can
+    // still be spread over multiple threads.
+    const streamChunk& chunk = this->ctx->chunks[chunkIndex];
+    this->assemblyJobs.Clear();
+    int numVertices = 0;
+    int numIndices = 0;
+    const int endCmdList = chunk.firstCmdList + chunk.numCmdLists;
+    for (int cmdListIndex = chunk.firstCmdList; cmdListIndex < endCmdList; cmdListIndex++) {
+        const ImDrawList* cmd_list = drawData->CmdLists[cmdListIndex];
+        if (!this->fitsIntoChunk(cmd_list)) {
+            continue;
+        }
+        const int cmdListNumVertices = cmd_list->VtxBuffer.size();
+        const int cmdListNumIndices  = cmd_list->IdxBuffer.size();
+        const int numSlices = 1 + (cmdListNumIndices / AssemblyJobMaxIndices);
+        const int verticesPerSlice = (cmdListNumVertices + numSlices - 1) / numSlices;
+        const int indicesPerSlice = (cmdListNumIndices + numSlices - 1) / numSlices;
+        for (int slice = 0; slice < numSlices; slice++) {
+            const int firstVertex = slice * verticesPerSlice;
+            const int firstIndex = slice * indicesPerSlice;
+            assemblyJob& job = this->assemblyJobs.Add();
+            job.srcVertices = cmd_list->VtxBuffer.Data + firstVertex;
+            job.dstVertices = ((uint8_t*)this->vertexData) + (numVertices + firstVertex) * this->vertexSize;
+            job.compact = this->setup.CompactVertices;
+            job.numVertices = std::min(verticesPerSlice, cmdListNumVertices - firstVertex);
+            job.srcIndices = cmd_list->IdxBuffer.Data + firstIndex;
+            job.dstIndices = this->indexData + numIndices + firstIndex;
+            job.numIndices = std::min(indicesPerSlice, cmdListNumIndices - firstIndex);
+            job.baseVertexIndex = ImDrawIdx(numVertices);
+        }
+        numVertices += cmdListNumVertices;
+        numIndices += cmdListNumIndices;
+    }
+    o_assert_dbg((numVertices == chunk.numVertices) && (numIndices == chunk.numIndices));
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::runAssemblyJob(assemblyJob& job) {
+    if (job.numVertices > 0) {
+        if (job.compact) {
+            imguiKernels::QuantizeVertices((imguiCompactVertex*)job.dstVertices, job.srcVertices, job.numVertices, CompactPositionScale);
+        }
+        else {
+            Memory::Copy(job.srcVertices, job.dstVertices, job.numVertices * sizeof(ImDrawVert));
+        }
+    }
+    if (job.numIndices > 0) {
+        const TimePoint rebaseStartTime = Clock::Now();
+        imguiKernels::RebaseIndices(job.dstIndices, job.srcIndices, job.numIndices, job.baseVertexIndex);
+        job.rebaseTime = Clock::Since(rebaseStartTime);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::remapAtlasUVs(const ImDrawData* drawData, int chunkIndex) {
+    // The uvs of an atlased image are relative to the image, move them
+    // into the image's region of the atlas page. Only the vertices which
+    // the draw command's indices reference are touched: with draw list
+    // channels (Columns, ChannelsSplit) the vertices of different draw
+    // commands interleave, so an index range would also hit vertices of
+    // other commands. A per-chunk bitset makes sure that shared vertices
+    // are remapped only once.
+    const streamChunk& chunk = this->ctx->chunks[chunkIndex];
+    const int numWords = (chunk.numVertices + 31) / 32;
+    this->remappedVertices.Clear();
+    this->remappedVertices.Reserve(numWords);
+    for (int i = 0; i < numWords; i++) {
+        this->remappedVertices.Add(0);
+    }
+    uint32_t* visited = numWords > 0 ? &this->remappedVertices[0] : nullptr;
+    int baseVertex = 0;
+    const int endCmdList = chunk.firstCmdList + chunk.numCmdLists;
+    for (int cmdListIndex = chunk.firstCmdList; cmdListIndex < endCmdList; cmdListIndex++) {
+        const ImDrawList* cmd_list = drawData->CmdLists[cmdListIndex];
+        if (!this->fitsIntoChunk(cmd_list)) {
+            continue;
+        }
+        const ImDrawIdx* idx = cmd_list->IdxBuffer.Data;
+        for (const ImDrawCmd& cmd : cmd_list->CmdBuffer) {
+            const auto* image = cmd.UserCallback ? nullptr : this->imagePool.Lookup(cmd.TextureId);
+            if (image && (image->page >= 0)) {
+                if (this->setup.CompactVertices) {
+                    // the offset is in normalized short units, the scale applies as is
+                    imguiCompactVertex* vtx = (imguiCompactVertex*)this->vertexData;
+                    const float offsetU = image->uvOffset.x * 32767.0f;
+                    const float offsetV = image->uvOffset.y * 32767.0f;
+                    for (unsigned int i = 0; i < cmd.ElemCount; i++) {
+                        const int v = baseVertex + idx[i];
+                        const uint32_t bit = 1u << (v & 31);
+                        if (0 == (visited[v >> 5] & bit)) {
+                            visited[v >> 5] |= bit;
+                            vtx[v].u = int16_t(offsetU + float(vtx[v].u) * image->uvScale.x + 0.5f);
+                            vtx[v].v = int16_t(offsetV + float(vtx[v].v) * image->uvScale.y + 0.5f);
+                        }
+                    }
+                }
+                else {
+                    ImDrawVert* vtx = this->vertexData;
+                    for (unsigned int i = 0; i < cmd.ElemCount; i++) {
+                        const int v = baseVertex + idx[i];
+                        const uint32_t bit = 1u << (v & 31);
+                        if (0 == (visited[v >> 5] & bit)) {
+                            visited[v >> 5] |= bit;
+                            vtx[v].uv.x = image->uvOffset.x + vtx[v].uv.x * image->uvScale.x;
+                            vtx[v].uv.y = image->uvOffset.y + vtx[v].uv.y * image->uvScale.y;
+                        }
+                    }
+                }
+            }
+            idx += cmd.ElemCount;
+        }
+        baseVertex += cmd_list->VtxBuffer.size();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::buildBatches(const ImDrawData* drawData, int numChunks) {
+    // Adjacent draw commands can be merged into a single draw call if
+    // they are in the same stream chunk and use the same texture and
+    // clip rect. Since all draw lists of a chunk live in one index
+    // buffer this also works across draw list boundaries.
+    IMUIFrameStats& stats = this->ctx->frameStats;
+    this->batches.Clear();
+    int prevIndex = -1;
+    ImTextureID prevTextureId = nullptr;
+    int prevPage = InvalidIndex;
+    for (int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++) {
+        const streamChunk& chunk = this->ctx->chunks[chunkIndex];
+        int elmOffset = 0;
+        const int endCmdList = chunk.firstCmdList + chunk.numCmdLists;
+        for (int cmdListIndex = chunk.firstCmdList; cmdListIndex < endCmdList; cmdListIndex++) {
+            const ImDrawList* cmd_list = drawData->CmdLists[cmdListIndex];
+            if (!this->fitsIntoChunk(cmd_list)) {
+                continue;
+            }
+            const ImDrawCmd* pcmd_end = cmd_list->CmdBuffer.end();
+            for (const ImDrawCmd* pcmd = cmd_list->CmdBuffer.begin(); pcmd != pcmd_end; pcmd++) {
+                if (pcmd->UserCallback) {
+                    drawBatch& batch = this->batches.Add();
+                    batch.chunkIndex = chunkIndex;
+                    batch.cmdList = cmd_list;
+                    batch.callbackCmd = pcmd;
+                    prevIndex = -1;
+                }
+                else if (pcmd->ElemCount > 0) {
+                    stats.NumDrawCmds++;
+                    // unbound and stale image handles render as white
+                    Id texture;
+                    int page = InvalidIndex;
+                    if (const auto* image = this->imagePool.Lookup(pcmd->TextureId)) {
+                        page = image->page;
+                        texture = page >= 0 ? this->imageAtlas.PageTexture(page) : image->texture;
+                    }
+                    if (!texture.IsValid()) {
+                        texture = this->whiteTexture;
+                        page = InvalidIndex;
+                    }
+                    // only different images on the same atlas page count
+                    // as a saved switch, not handles which fall back to white
+                    if ((pcmd->TextureId != prevTextureId) && (page >= 0) && (page == prevPage)) {
+                        stats.NumTextureSwitchesSaved++;
+                    }
+                    prevTextureId = pcmd->TextureId;
+                    prevPage = page;
+                    const int pipeline = (texture == this->fontTexture) ? FontPipeline : DefaultPipeline;
+                    drawBatch* prev = prevIndex >= 0 ? &this->batches[prevIndex] : nullptr;
+                    if (prev &&
+                        (prev->chunkIndex == chunkIndex) &&
+                        (prev->texture == texture) &&
+                        (prev->clipRect.x == pcmd->ClipRect.x) &&
+                        (prev->clipRect.y == pcmd->ClipRect.y) &&
+                        (prev->clipRect.z == pcmd->ClipRect.z) &&
+                        (prev->clipRect.w == pcmd->ClipRect.w) &&
+                        ((prev->baseElement + prev->numElements) == elmOffset)) {
+                        prev->numElements += pcmd->ElemCount;
+                        stats.NumDrawsSaved++;
+                    }
+                    else {
+                        drawBatch& batch = this->batches.Add();
+                        batch.chunkIndex = chunkIndex;
+                        batch.texture = texture;
+                        batch.pipeline = pipeline;
+                        batch.clipRect = pcmd->ClipRect;
+                        batch.baseElement = elmOffset;
+                        batch.numElements = pcmd->ElemCount;
+                        prevIndex = this->batches.Size() - 1;
+                    }
+                }
+                elmOffset += pcmd->ElemCount;
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+imguiWrapper::drawBatches() {
+    IMUIFrameStats& stats = this->ctx->frameStats;
+    const ImGuiIO& io = ImGui::GetIO();
+    const float width  = io.DisplaySize.x;
+    const float height = io.DisplaySize.y;
+    glm::mat4 ortho = glm::ortho(0.0f, width, height, 0.0f, -1.0f, 1.0f);
+    if (this->setup.CompactVertices) {
+        ortho = glm::scale(ortho, glm::vec3(1.0f / CompactPositionScale, 1.0f / CompactPositionScale, 1.0f));
+    }
+
+    // the uniform block only needs to be applied after the first
+    // ApplyDrawState and when the shader changes, unless a user
+    // callback has changed the draw state in between
+    static_assert(int(IMUIShader::tex) == int(IMUIFontShader::tex), "texture slot mismatch");
+    static_assert(int(IMUIShader::tex) == int(IMUIFontSDFShader::tex), "texture slot mismatch");
+    static_assert(int(IMUIShader::tex) == int(IMUIFontSDFFixedShader::tex), "texture slot mismatch");
+    const pipelineSet& pipelines = this->pipelineSets[this->ctx->pipelineSet];
+    bool applyDrawState = true;
+    bool applyUniforms = true;
+    bool applyScissor = true;
+    int curChunk = -1;
+    int curPipeline = -1;
+    Id curTexture;
+    int curScissor[4] = { };
+    for (const drawBatch& batch : this->batches) {
+        if (batch.callbackCmd) {
+            batch.callbackCmd->UserCallback(batch.cmdList, batch.callbackCmd);
+            applyDrawState = applyUniforms = applyScissor = true;
+            continue;
+        }
+        if (applyDrawState || (curChunk != batch.chunkIndex) || (curTexture != batch.texture) || (curPipeline != batch.pipeline)) {
+            if (pipelines.pipelines[batch.pipeline] != this->drawState.Pipeline) {
+                applyUniforms = true;
+            }
+            if (curTexture != batch.texture) {
+                stats.NumTextureChanges++;
+            }
+            this->drawState.Pipeline = pipelines.pipelines[batch.pipeline];
+            this->drawState.Mesh[0] = this->ctx->chunks[batch.chunkIndex].mesh();
+            this->drawState.FSTexture[IMUIShader::tex] = batch.texture;
+            curChunk = batch.chunkIndex;
+            curTexture = batch.texture;
+            curPipeline = batch.pipeline;
+            applyDrawState = false;
+            Gfx::ApplyDrawState(this->drawState);
+            stats.NumApplyDrawState++;
+        }
+        if (applyUniforms) {
+            applyUniforms = false;
+            if (this->setup.SDFFonts && (FontPipeline == batch.pipeline)) {
+                #if ORYOL_OPENGLES2
+                IMUIFontSDFFixedShader::vsParams vsParams;
+                IMUIFontSDFFixedShader::fsParams fsParams;
+                fsParams.aaWidth = this->sdfFixedWidth;
+                #else
+                IMUIFontSDFShader::vsParams vsParams;
+                IMUIFontSDFShader::fsParams fsParams;
+                #endif
+                vsParams.ortho = ortho;
+                fsParams.coverageV = this->sdfCoverageV;
+                Gfx::ApplyUniformBlock(vsParams);
+                Gfx::ApplyUniformBlock(fsParams);
+                stats.NumApplyUniformBlock++;
+            }
+            else if (this->setup.Alpha8FontAtlas && (FontPipeline == batch.pipeline)) {
+                IMUIFontShader::vsParams vsParams;
+                vsParams.ortho = ortho;
+                Gfx::ApplyUniformBlock(vsParams);
+            }
+            else {
+                IMUIShader::vsParams vsParams;
+                vsParams.ortho = ortho;
+                Gfx::ApplyUniformBlock(vsParams);
+            }
+            stats.NumApplyUniformBlock++;
+        }
+        const int scissor[4] = {
+            (int)batch.clipRect.x,
+            (int)(height - batch.clipRect.w),
+            (int)(batch.clipRect.z - batch.clipRect.x),
+            (int)(batch.clipRect.w - batch.clipRect.y)
+        };
+        if (applyScissor ||
+            (scissor[0] != curScissor[0]) || (scissor[1] != curScissor[1]) ||
+            (scissor[2] != curScissor[2]) || (scissor[3] != curScissor[3])) {
+            applyScissor = false;
+            Gfx::ApplyScissorRect(scissor[0], scissor[1], scissor[2], scissor[3]);
+            stats.NumApplyScissorRect++;
+            for (int i = 0; i < 4; i++) {
+                curScissor[i] = scissor[i];
+            }
+        }
+        else {
+            stats.NumScissorRectsSaved++;
+        }
+        Gfx::Draw(PrimitiveGroup(batch.baseElement, batch.numElements));
+        stats.NumDraws++;
     }
-    Gfx::ApplyScissorRect(0, 0, (int)ImGui::GetIO().DisplaySize.x, (int)ImGui::GetIO().DisplaySize.y);
+    Gfx::ApplyScissorRect(0, 0, (int)width, (int)height);
+    stats.NumApplyScissorRect++;
 }
 
 } // namespace _priv
@@ -6,9 +6,25 @@
 */
 #include "Core/Types.h"
 #include "Core/Containers/StaticArray.h"
+#include "Core/Containers/Map.h"
+#include "Core/Containers/Array.h"
 #include "Gfx/Gfx.h"
+#include "Input/Input.h"
+#include "Core/Time/TimePoint.h"
+#include "glm/vec2.hpp"
 #include "imgui.h"
 #include "IMUI/IMUISetup.h"
+#include "IMUI/IMUITypes.h"
+#include "IMUI/imguiWorkerPool.h"
+#include "IMUI/imguiImagePool.h"
+#include "IMUI/imguiImageAtlas.h"
+#include "IMUI/imguiCapture.h"
+#include "IMUI/imguiPlotRenderer.h"
+#include "IMUI/imguiFontBaker.h"
+#if ORYOL_HAS_THREADS
+#include <atomic>
+#include <thread>
+#endif
 
 namespace Oryol {
 namespace _priv {
@@ -23,40 +39,361 @@ public:
     bool IsValid() const;
     /// call before issuing ImGui commands
     void NewFrame(float frameDurationInSeconds);
+    /// return true if the UI needs to be updated this frame
+    bool NeedsUpdate() const;
+    /// return seconds until the UI needs the next update (0 if now)
+    float SecondsToNextUpdate() const;
+    /// request that the next N frames are updated
+    void RequestUpdate(int numFrames);
+    /// queue an input event for the current context
+    void InjectInputEvent(const IMUIInputEvent& event);
+    /// apply mouse moves which were queued since NewFrame() (call right before ImGui::Render())
+    void LatchInput();
+    /// return true if the setup fonts are baked and in use
+    bool FontsReady() const;
+    /// wait for the background font bake and swap in the baked atlas
+    void WaitForFonts();
+    /// register glyphs in an UTF-8 string as used (with IMUISetup::DynamicGlyphs)
+    void UseGlyphs(const char* text);
     /// grab a new ImTextureID
     ImTextureID AllocImage();
     /// free a ImTextureID
     void FreeImage(ImTextureID img);
     /// associate an ImTextureID with an Oryol texture
     void BindImage(ImTextureID img, Id texId);
+    /// copy an image into the image atlas and associate it with an ImTextureID
+    bool BindImagePixels(ImTextureID img, const void* rgba8Pixels, int width, int height);
+    /// get current memory usage
+    IMUIMemoryUsage MemoryUsage() const;
+    /// get the counters of the current (or last completed) frame
+    const IMUIFrameStats& FrameStats() const;
+    /// get information about the font atlas
+    const IMUIFontAtlasInfo& FontAtlasInfo() const;
+    /// get number of frames in the stats history
+    int NumFrameStatsHistory() const;
+    /// get the stats of a completed frame
+    const IMUIFrameStats& FrameStatsHistory(int framesAgo) const;
+    /// draw the stats window
+    void ShowStatsWindow(bool* open);
+    /// plot a sample array as lines or bars drawn on the GPU
+    void PlotGPU(imguiPlotRenderer::plotType type, const char* label, const float* values, int count, float scaleMin, float scaleMax, ImVec2 size);
+    /// create a new context
+    int CreateContext(const IMUIContextSetup& ctxSetup);
+    /// destroy a context
+    void DestroyContext(int ctxIndex);
+    /// make a context current
+    void SetContext(int ctxIndex);
+    /// get index of the current context
+    int Context() const;
+    /// start writing the rendered frames of the current context to a capture file
+    bool BeginCapture(const char* path, bool delta);
+    /// stop writing frames to the capture file
+    void EndCapture();
+    /// return true if frames are currently captured
+    bool IsCapturing() const;
+    /// open a capture file for replay
+    bool BeginReplay(const char* path);
+    /// render the next frame from the capture file, returns false at the end
+    bool ReplayFrame();
+    /// get the frame stats of the last replayed frame
+    const IMUIFrameStats& ReplayFrameStats() const;
+    /// close the replayed capture file
+    void EndReplay();
 
     /// setup font texture
     void setupFontTexture(const IMUISetup& setup);
+    /// add ImGui's default font and the setup fonts to a font atlas
+    void addFonts(ImFontAtlas* atlas, ImFont** outFonts);
+    /// get the setup font whose distance field glyphs a setup font can share (itself if none)
+    int sdfSourceFont(int fontIndex) const;
+    /// turn the baked atlas pixels into a distance field (may run on the font bake thread)
+    void bakeSDFAtlas(imguiFontBaker& baker);
+    /// expand the distance field glyph quads and create the scaled font copies (main thread only)
+    void finishSDFAtlas(ImFontAtlas* atlas, ImFont** fonts);
+    /// hand a serialized font atlas to IMUISetup::FontCacheWriteFunc
+    void saveFontCache(uint64_t cacheKey);
+    /// swap in the atlas baked on the background thread (must be outside of any ImGui frame)
+    void finishFontBake();
+    /// create the font texture from the (built) font atlas
+    void createFontTexture();
+    /// get the pixel height of the coverage band at the top of a distance field atlas
+    static int coverageBandHeight(const ImFontAtlas* atlas);
+    /// mark a glyph as used, adds it to the dynamic glyph set if it's not resident
+    void useGlyph(unsigned int c);
+    /// build the glyph ranges of a setup font for the dynamic glyph set
+    const ImWchar* buildDynamicGlyphRanges(int fontIndex);
+    /// evict least recently used glyphs, re-bake the atlas and re-create the font texture
+    void rebuildFontAtlas();
+    /// test if a character is in a zero-terminated list of glyph ranges
+    static bool inGlyphRanges(const ImWchar* ranges, unsigned int c);
     /// setup draw state
     void setupMeshAndDrawState();
+    /// create a pipeline object for a vertex layout (and optional instance layout) and a shader
+    Id createPipeline(const Id& shd, const VertexLayout& layout, const VertexLayout* instanceLayout, PixelFormat::Code colorFormat, PixelFormat::Code depthFormat, int sampleCount);
+    /// draw callback of GPU plots
+    static void plotCallback(const ImDrawList* cmdList, const ImDrawCmd* cmd);
     /// setup dummy 'white' texture
     void setupWhiteTexture();
-    /// imgui's draw callback
+    /// snapshot of the input state relevant for idle detection
+    struct inputState {
+        glm::vec2 mousePos;
+        glm::vec2 mouseScroll;
+        uint32_t mouseButtons = 0;
+        uint32_t keys = 0;
+        uint32_t modifiers = 0;
+        bool text = false;
+        bool touch = false;
+        /// return true if input happens right now (buttons or keys held, text, touch, scroll)
+        bool isActive() const;
+        /// compare mouse position and button/key state
+        bool operator==(const inputState& rhs) const;
+    };
+    /// capture the current input state
+    static inputState captureInputState();
+    /// an input event and the context frame in which it was queued
+    struct queuedInputEvent {
+        IMUIInputEvent event;
+        int frame = 0;
+    };
+    /// Oryol Input event callback (with IMUISetup::InputEventQueue)
+    static void onInputEvent(const InputEvent& event);
+    /// forward Oryol Input state to ImGui (without IMUISetup::InputEventQueue, and touch input)
+    void pollInput();
+    /// move the current frame's stats into the stats history and reset them
+    void beginFrameStats();
+    /// imgui's draw callback, renders with the context of the current ImGui context
     static void imguiRenderDrawLists(ImDrawData* draw_data);
+    /// upload and draw a frame of the current context
+    void renderDrawData(ImDrawData* draw_data);
 
+    /// test if a draw list fits into a single stream chunk
+    bool fitsIntoChunk(const ImDrawList* cmdList) const;
+    /// distribute the draw lists over stream chunks, return number of chunks
+    int assignChunks(const ImDrawData* drawData);
+    /// grow stream chunks to this frame's size, shrink or drop idle chunks
+    void updateChunkCapacities(int numUsedChunks);
+    /// compute a fingerprint of the vertex and index data in a frame
+    static uint64_t hashDrawData(const ImDrawData* drawData);
+    /// copy this frame's geometry into the stream chunks
+    void uploadChunks(const ImDrawData* drawData, int numChunks);
+    /// a range of vertices and indices to copy into the staging buffers
+    struct assemblyJob {
+        const ImDrawVert* srcVertices = nullptr;
+        /// ImDrawVert or imguiCompactVertex
+        void* dstVertices = nullptr;
+        bool compact = false;
+        int numVertices = 0;
+        const ImDrawIdx* srcIndices = nullptr;
+        ImDrawIdx* dstIndices = nullptr;
+        int numIndices = 0;
+        ImDrawIdx baseVertexIndex = 0;
+        Duration rebaseTime;
+    };
+    /// max number of indices handled by a single assembly job
+    static const int AssemblyJobMaxIndices = 16 * 1024;
+    /// return the draw list if a chunk can be uploaded without staging copy, otherwise nullptr
+    const ImDrawList* directUploadList(const ImDrawData* drawData, int chunkIndex) const;
+    /// copy, rebase and remap the vertices and indices of a stream chunk into the staging buffers (CPU only)
+    void assembleChunk(const ImDrawData* drawData, int chunkIndex);
+    /// split the draw lists of a stream chunk into assembly jobs
+    void buildAssemblyJobs(const ImDrawData* drawData, int chunkIndex);
+    /// copy and rebase the vertices and indices of one assembly job
+    static void runAssemblyJob(assemblyJob& job);
+    /// move the uvs of atlased images into their atlas page region
+    void remapAtlasUVs(const ImDrawData* drawData, int chunkIndex);
+    /// merge this frame's draw commands into draw batches
+    void buildBatches(const ImDrawData* drawData, int numChunks);
+    /// issue the Gfx calls for this frame's draw batches
+    void drawBatches();
+    /// (re-)create the stream mesh of a chunk with a new capacity
+    void createChunkMesh(int chunkIndex, int numVertices, int numIndices);
+    /// setup the staging buffer limits from the IMUISetup memory budget
+    void setupStaging();
+    /// resize the staging buffers (no-op when they live in a user-provided arena)
+    void resizeStaging(int numVertices, int numIndices);
+    /// free the staging buffers
+    void discardStaging();
+
+    /// upper limit for number of vertices and indices in one stream chunk
     static const int MaxNumVertices = 64 * 1024;
     static const int MaxNumIndices = 128 * 1024;
+    /// max depth of the stream mesh ring
+    static const int MaxStreamBuffers = 4;
     static const int MaxNumFonts = 4;
+    /// fixed-point scale of compact vertex positions (1/4 pixel precision, +-8K pixels range)
+    static constexpr float CompactPositionScale = 4.0f;
+    /// update interval while a text field is focused (blinking cursor)
+    static constexpr float CursorBlinkSeconds = 0.2f;
+    /// value returned by SecondsToNextUpdate() if nothing is pending
+    static constexpr float IdleSeconds = 1.0e6f;
 
     static imguiWrapper* self;
 
     IMUISetup setup;
     bool isValid = false;
+    /// set by IMUIBench: stream chunks only track their capacities and get no meshes
+    bool headless = false;
     ResourceLabel resLabel;
     DrawState drawState;
+    /// pipeline for user images, and for the font atlas (may be the same)
+    enum {
+        DefaultPipeline = 0,
+        FontPipeline,
+        NumPipelines
+    };
+    StaticArray<Id, NumPipelines> shaders;
+    /// quad mesh and shaders of GPU plots (invalid without instancing support)
+    Id plotQuadMesh;
+    StaticArray<Id, imguiPlotRenderer::NumPlotTypes> plotShaders;
+    /// the pipelines for one render target format
+    struct pipelineSet {
+        PixelFormat::Code colorFormat = PixelFormat::InvalidPixelFormat;
+        PixelFormat::Code depthFormat = PixelFormat::InvalidPixelFormat;
+        int sampleCount = 0;
+        StaticArray<Id, NumPipelines> pipelines;
+        StaticArray<Id, imguiPlotRenderer::NumPlotTypes> plotPipelines;
+    };
+    Array<pipelineSet> pipelineSets;
+    /// find or create the pipelines for the render target format of a context, returns index
+    int lookupPipelineSet(const IMUIContextSetup& ctxSetup);
+    VertexLayout vertexLayout;
+    /// size of an uploaded vertex, sizeof(ImDrawVert) or sizeof(imguiCompactVertex)
+    int vertexSize = sizeof(ImDrawVert);
     StaticArray<ImFont*, MaxNumFonts> fonts;
     Id whiteTexture;
     Id fontTexture;
-    static const int MaxImages = 256;
-    StaticArray<Id, MaxImages> images;
-    Array<intptr_t> freeImageSlots;
-    ImDrawVert vertexData[MaxNumVertices];
-    ImDrawIdx indexData[MaxNumIndices];
+    ResourceLabel fontTextureLabel;
+    /// highest codepoint which is always baked into the atlas with IMUISetup::DynamicGlyphs
+    static const unsigned int MaxResidentGlyph = 0xFF;
+    /// glyphs baked on demand, mapped to the frame counter of their last use
+    Map<ImWchar, int> dynamicGlyphs;
+    bool dynamicGlyphsDirty = false;
+    StaticArray<ImVector<ImWchar>, MaxNumFonts> dynamicGlyphRanges;
+    static const int InitialImageCapacity = 256;
+    imguiImagePool imagePool;
+    imguiImageAtlas imageAtlas;
+
+    /// a ring of stream meshes and the draw lists assigned to it in the current frame
+    struct streamChunk {
+        ResourceLabel label;
+        StaticArray<Id, MaxStreamBuffers> meshes;
+        int curMesh = 0;
+        /// get the mesh used in the current frame
+        const Id& mesh() const {
+            return this->meshes[this->curMesh];
+        }
+        int vertexCapacity = 0;
+        int indexCapacity = 0;
+        int firstCmdList = 0;
+        int numCmdLists = 0;
+        int numVertices = 0;
+        int numIndices = 0;
+        int highWaterVertices = 0;
+        int highWaterIndices = 0;
+        int idleFrames = 0;
+    };
+    /// a range of elements in a stream chunk drawn with one draw call,
+    /// or a user callback (callbackCmd != nullptr)
+    struct drawBatch {
+        int chunkIndex = 0;
+        Id texture;
+        int pipeline = 0;
+        ImVec4 clipRect;
+        int baseElement = 0;
+        int numElements = 0;
+        const ImDrawList* cmdList = nullptr;
+        const ImDrawCmd* callbackCmd = nullptr;
+    };
+    Array<drawBatch> batches;
+    Array<assemblyJob> assemblyJobs;
+    /// one bit per vertex of a stream chunk, set once its uv has been moved into the atlas
+    Array<uint32_t> remappedVertices;
+    imguiWorkerPool workerPool;
+    int numStreamBuffers = 1;
+    int minChunkVertices = 0;
+    int minChunkIndices = 0;
+    int maxChunkVertices = 0;
+    int maxChunkIndices = 0;
+
+    /// staging buffers, sized to the biggest stream chunk
+    ImDrawVert* vertexData = nullptr;
+    ImDrawIdx* indexData = nullptr;
+    int stagingVertexCapacity = 0;
+    int stagingIndexCapacity = 0;
+    bool stagingInArena = false;
+    int textureBytes = 0;
+    int fontAtlasBytes = 0;
+    IMUIFontAtlasInfo fontAtlasInfo;
+    /// with IMUISetup::SDFFonts: end of the coverage band in texture coordinates
+    float sdfCoverageV = 0.0f;
+    /// with IMUISetup::SDFFonts on GLES2: constant antialiasing width in distance units
+    float sdfFixedWidth = 0.0f;
+    /// with IMUISetup::AsyncFontBake: the atlas and fonts baked on the background thread
+    ImFontAtlas* pendingFontAtlas = nullptr;
+    StaticArray<ImFont*, MaxNumFonts> pendingFonts;
+    /// rasterizes the glyphs of SDF and async atlases without ImGui allocations
+    imguiFontBaker fontBaker;
+    TimePoint fontBakeStartTime;
+    bool fontBakeSaveCache = false;
+    #if ORYOL_HAS_THREADS
+    std::thread fontBakeThread;
+    std::atomic<bool> fontBakeDone{false};
+    #endif
+    /// counts NewFrame() calls over all contexts
+    int frameCount = 0;
+    /// with IMUISetup::InputEventQueue: subscribed to Oryol Input events
+    Input::CallbackId inputCallbackId = 0;
+    bool inputSubscribed = false;
+
+    /// an ImGui context with its own stream meshes, input routing and
+    /// update tracking, the font atlas and all other gfx resources are
+    /// shared between contexts
+    static const int MaxFrameStatsHistory = 120;
+    struct context {
+        ImGuiContext* imguiContext = nullptr;
+        IMUIContextSetup setup;
+        Array<streamChunk> chunks;
+        uint64_t geometryHash = 0;
+        bool geometryHashValid = false;
+        IMUIFrameStats frameStats;
+        /// ring buffer of the stats of completed frames
+        StaticArray<IMUIFrameStats, MaxFrameStatsHistory> frameStatsHistory;
+        int frameStatsHistoryPos = 0;
+        int numFrameStatsHistory = 0;
+        bool frameStatsComplete = false;
+        imguiPlotRenderer plots;
+        inputState lastInput;
+        /// queued input events, and time of the oldest event applied this frame
+        Array<queuedInputEvent> inputEvents;
+        TimePoint oldestInputTime;
+        /// counts NewFrame() calls of this context
+        int frameIndex = 0;
+        /// index into pipelineSets
+        int pipelineSet = InvalidIndex;
+        TimePoint lastActivityTime;
+        int numRequestedFrames = 0;
+    };
+    /// create a context (its stream chunks are created on demand), returns context index
+    int createContext(const IMUIContextSetup& ctxSetup);
+    /// destroy a context and its stream meshes
+    void destroyContext(int ctxIndex);
+    /// push an input event into the queue of a context, drops the oldest event if full
+    void queueInputEvent(context& c, const IMUIInputEvent& event);
+    /// apply queued input events in order to the current ImGui context, only mouse moves if latch is true
+    void applyInputEvents(context& c, bool latch);
+    /// test if a mouse button changes a second time in the queued events after firstEvent
+    bool buttonChangeDeferred(const context& c, int firstEvent, const bool* buttonChanged, const bool* keyChanged) const;
+    /// the font atlas shared by all contexts
+    ImFontAtlas* fontAtlas = nullptr;
+    /// all contexts (destroyed contexts leave a nullptr), and the current context
+    Array<context*> contexts;
+    context* ctx = nullptr;
+    /// capture file writer or reader, and the context which is captured
+    imguiCapture capture;
+    context* captureContext = nullptr;
+    /// replayed frames go through their own context, so that they don't
+    /// share stream meshes with the frames rendered by the app
+    int replayContext = InvalidIndex;
 };
 
 } // namespace _priv
@@ -0,0 +1,650 @@
+//------------------------------------------------------------------------------
+//  IMUIBench.cc
+//
+//  Headless CPU benchmarks of the IMUI render path: the inner-loop
+//  kernels, and chunk assignment, vertex/index assembly and draw
+//  batching on generated draw data, plus IMUITable frames while rows
+//  are appended. No window or Gfx setup is needed, results go to
+//  stdout and optionally into a JSON file (see benchRunner.h for the
+//  command line options). With --replay the frames of a capture file
+//  are run through the render path instead.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Time/Clock.h"
+#include "IMUI/imguiKernels.h"
+#include "IMUI/imguiImagePool.h"
+#include "IMUI/imguiCapture.h"
+#include "IMUI/IMUITable.h"
+#include "benchRunner.h"
+#include "benchWorkload.h"
+#include "benchRenderPath.h"
+#include <cstdio>
+#include <cmath>
+#include <cfloat>
+#include <atomic>
+#include <functional>
+
+using namespace Oryol;
+using namespace Oryol::_priv;
+
+//------------------------------------------------------------------------------
+static void
+benchKernels(benchRunner& runner) {
+    const int numIndices = 128 * 1024;
+    const int numVertices = 64 * 1024;
+    uint16_t* srcIndices = (uint16_t*) Memory::Alloc(numIndices * sizeof(uint16_t));
+    uint16_t* dstIndices = (uint16_t*) Memory::Alloc(numIndices * sizeof(uint16_t));
+    for (int i = 0; i < numIndices; i++) {
+        srcIndices[i] = uint16_t(i & 0x7FFF);
+    }
+    ImDrawVert* srcVertices = (ImDrawVert*) Memory::Alloc(numVertices * sizeof(ImDrawVert));
+    imguiCompactVertex* dstVertices = (imguiCompactVertex*) Memory::Alloc(numVertices * sizeof(imguiCompactVertex));
+    for (int i = 0; i < numVertices; i++) {
+        srcVertices[i].pos = ImVec2(float(i % 4096) + 0.25f, float(i / 4096) * 3.5f);
+        srcVertices[i].uv = ImVec2(float(i & 255) / 256.0f, float((i >> 8) & 255) / 256.0f);
+        srcVertices[i].col = 0xFFFFFFFF;
+    }
+
+    runner.Run("kernel.rebase_indices", "128k indices", numIndices, [=]() {
+        imguiKernels::RebaseIndices(dstIndices, srcIndices, numIndices, uint16_t(1234));
+    });
+    runner.Run("kernel.quantize_vertices", "64k vertices", numVertices, [=]() {
+        imguiKernels::QuantizeVertices(dstVertices, srcVertices, numVertices, 4.0f);
+    });
+    const int hashBytes = numVertices * sizeof(ImDrawVert);
+    uint64_t hash = 0;
+    runner.Run("kernel.hash", "1.25 MB", hashBytes, [=, &hash]() {
+        hash = imguiKernels::Hash(srcVertices, hashBytes, hash);
+    });
+
+    Memory::Free(srcIndices);
+    Memory::Free(dstIndices);
+    Memory::Free(srcVertices);
+    Memory::Free(dstVertices);
+}
+
+//------------------------------------------------------------------------------
+static void
+rebaseScalar(uint16_t* dst, const uint16_t* src, int num, uint16_t baseVertexIndex) {
+    // the plain loop RebaseIndices() replaced, as baseline
+    for (int i = 0; i < num; i++) {
+        dst[i] = src[i] + baseVertexIndex;
+    }
+}
+
+//------------------------------------------------------------------------------
+static void
+benchRebase(benchRunner& runner) {
+    // index rebasing over typical draw list sizes, SIMD kernel vs. scalar
+    // loop, and the 32-bit index variant
+    const int maxIndices = 128 * 1024;
+    uint16_t* src16 = (uint16_t*) Memory::Alloc(maxIndices * sizeof(uint16_t));
+    uint16_t* dst16 = (uint16_t*) Memory::Alloc(maxIndices * sizeof(uint16_t));
+    uint32_t* src32 = (uint32_t*) Memory::Alloc(maxIndices * sizeof(uint32_t));
+    uint32_t* dst32 = (uint32_t*) Memory::Alloc(maxIndices * sizeof(uint32_t));
+    for (int i = 0; i < maxIndices; i++) {
+        src16[i] = uint16_t(i & 0x7FFF);
+        src32[i] = uint32_t(i);
+    }
+    const int sizes[] = { 96, 1024, 16 * 1024, maxIndices };
+    for (int num : sizes) {
+        char params[32];
+        snprintf(params, sizeof(params), "%d indices", num);
+        runner.Run("rebase.simd16", params, num, [=]() {
+            imguiKernels::RebaseIndices(dst16, src16, num, uint16_t(1234));
+        });
+        runner.Run("rebase.scalar16", params, num, [=]() {
+            rebaseScalar(dst16, src16, num, uint16_t(1234));
+        });
+        runner.Run("rebase.simd32", params, num, [=]() {
+            imguiKernels::RebaseIndices(dst32, src32, num, uint32_t(123456));
+        });
+    }
+    Memory::Free(src16);
+    Memory::Free(dst16);
+    Memory::Free(src32);
+    Memory::Free(dst32);
+}
+
+//------------------------------------------------------------------------------
+static void
+benchImagePool(benchRunner& runner) {
+    // a pool with numLive images, per run numChurn random images are
+    // freed and re-allocated (so slots get reused with new generations),
+    // and lookups go over live and stale handles like in batch building
+    const int numLive = 4096;
+    const int numChurn = 512;
+    const int numLookups = 64 * 1024;
+    const Id tex(Id::UniqueStampT(1), Id::SlotIndexT(0), GfxResourceType::Texture);
+    imguiImagePool pool;
+    pool.Setup(64);
+    Array<ImTextureID> live;
+    Array<ImTextureID> stale;
+    live.Reserve(numLive);
+    stale.Reserve(numChurn);
+    for (int i = 0; i < numLive; i++) {
+        ImTextureID img = pool.Alloc();
+        pool.Bind(img, tex);
+        live.Add(img);
+    }
+    uint32_t rnd = 0x12345678;
+    auto next = [&rnd]() -> uint32_t {
+        rnd = rnd * 1664525 + 1013904223;
+        return rnd >> 8;
+    };
+
+    runner.Run("image_pool.churn", "4096 live, 512 free+alloc", numChurn, [&]() {
+        stale.Clear();
+        for (int i = 0; i < numChurn; i++) {
+            const int index = int(next() % uint32_t(numLive));
+            stale.Add(live[index]);
+            pool.Free(live[index]);
+            live[index] = pool.Alloc();
+            pool.Bind(live[index], tex);
+        }
+    });
+    if (runner.Enabled("image_pool.lookup")) {
+        int numFound = 0;
+        runner.Run("image_pool.lookup", "64k lookups, 1/8 stale", numLookups, [&]() {
+            numFound = 0;
+            for (int i = 0; i < numLookups; i++) {
+                const uint32_t r = next();
+                const bool useStale = ((r & 7) == 0) && !stale.Empty();
+                const ImTextureID img = useStale ? stale[r % uint32_t(stale.Size())] : live[r % uint32_t(numLive)];
+                if (pool.Lookup(img)) {
+                    numFound++;
+                }
+            }
+        });
+        runner.Counter("found", numFound);
+        runner.Counter("capacity", pool.Capacity());
+    }
+    runner.Run("image_pool.alloc_free_all", "4096 images", numLive, [&]() {
+        for (ImTextureID img : live) {
+            pool.Free(img);
+        }
+        for (ImTextureID& img : live) {
+            img = pool.Alloc();
+            pool.Bind(img, tex);
+        }
+    });
+    pool.Discard();
+}
+
+//------------------------------------------------------------------------------
+static void
+addFrameCounters(benchRunner& runner, const IMUIFrameStats& stats) {
+    runner.Counter("cmd_lists", stats.NumCmdLists);
+    runner.Counter("chunks", stats.NumChunks);
+    runner.Counter("vertices", stats.NumVertices);
+    runner.Counter("indices", stats.NumIndices);
+    runner.Counter("draw_cmds", stats.NumDrawCmds);
+    runner.Counter("draws_saved", stats.NumDrawsSaved);
+    runner.Counter("bytes_copied", stats.BytesCopied);
+}
+
+//------------------------------------------------------------------------------
+static void
+benchFrame(benchRunner& runner, const char* name, const char* params, const IMUISetup& setup, const std::function<const ImDrawData*(benchRenderPath&)>& makeDrawData) {
+    benchRenderPath path;
+    path.Setup(setup);
+    const ImDrawData* drawData = makeDrawData(path);
+    const int numVertices = drawData->TotalVtxCount;
+    int numChunks = path.AssignChunks(drawData);
+    char fullName[64];
+
+    snprintf(fullName, sizeof(fullName), "%s.assign_chunks", name);
+    runner.Run(fullName, params, drawData->CmdListsCount, [&]() {
+        numChunks = path.AssignChunks(drawData);
+    });
+    snprintf(fullName, sizeof(fullName), "%s.assemble", name);
+    runner.Run(fullName, params, numVertices, [&]() {
+        path.Assemble(drawData, numChunks);
+    });
+    snprintf(fullName, sizeof(fullName), "%s.build_batches", name);
+    runner.Run(fullName, params, numVertices, [&]() {
+        path.BuildBatches(drawData, numChunks);
+    });
+    snprintf(fullName, sizeof(fullName), "%s.frame", name);
+    if (runner.Enabled(fullName)) {
+        runner.Run(fullName, params, numVertices, [&]() {
+            path.Frame(drawData);
+        });
+        IMUIFrameStats stats = path.Stats();
+        for (int chunkIndex = 0; chunkIndex < stats.NumChunks; chunkIndex++) {
+            stats.NumVertices += path.wrapper.ctx->chunks[chunkIndex].numVertices;
+            stats.NumIndices += path.wrapper.ctx->chunks[chunkIndex].numIndices;
+        }
+        addFrameCounters(runner, stats);
+    }
+    path.Discard();
+}
+
+//------------------------------------------------------------------------------
+static void
+benchRenderPaths(benchRunner& runner, benchWorkload& workload) {
+    IMUISetup setup;
+
+    // a typical tool UI: many windows with text and widgets
+    benchFrame(runner, "widgets", "64 windows x 48 rows", setup, [&workload](benchRenderPath&) {
+        return workload.Widgets(64, 48);
+    });
+    // few huge draw lists which spill over into several chunks
+    benchFrame(runner, "quads", "8 lists x 16k quads", setup, [&workload](benchRenderPath&) {
+        return workload.Quads(8, 16 * 1024, 0, nullptr, 0);
+    });
+    // many small draw lists with frequent texture changes
+    benchFrame(runner, "images", "256 lists x 256 quads, 1/4 images", setup, [&workload](benchRenderPath& path) {
+        ImTextureID images[8];
+        for (auto& img : images) {
+            img = path.AllocImage();
+        }
+        return workload.Quads(256, 256, 4, images, 8);
+    });
+
+    // the same frames with 12-byte quantized vertices instead of 20-byte
+    // ImDrawVerts, assembly pays for the conversion, the upload is smaller
+    IMUISetup compactSetup;
+    compactSetup.CompactVertices = true;
+    benchFrame(runner, "compact.widgets", "64 windows x 48 rows", compactSetup, [&workload](benchRenderPath&) {
+        return workload.Widgets(64, 48);
+    });
+    benchFrame(runner, "compact.quads", "8 lists x 16k quads", compactSetup, [&workload](benchRenderPath&) {
+        return workload.Quads(8, 16 * 1024, 0, nullptr, 0);
+    });
+}
+
+//------------------------------------------------------------------------------
+static void
+benchChunkSpike(benchRunner& runner, benchWorkload& workload) {
+    // a single frame which needs 8 stream chunks in a run of frames
+    // which fit into one, the spare chunks have to be dropped again
+    // after StreamIdleFrames
+    IMUISetup setup;
+    setup.StreamIdleFrames = 60;
+    benchRenderPath path;
+    path.Setup(setup);
+    const int numFrames = 2 * setup.StreamIdleFrames;
+    int peakChunks = 0;
+    int dropFrame = -1;
+    runner.Run("chunks.spike", "1 frame 8 lists x 16k quads, 119 frames 1 list x 256 quads", numFrames, [&]() {
+        path.wrapper.ctx->chunks.Clear();
+        peakChunks = 0;
+        dropFrame = -1;
+        for (int frameIndex = 0; frameIndex < numFrames; frameIndex++) {
+            const ImDrawData* drawData = (0 == frameIndex) ? workload.Quads(8, 16 * 1024, 0, nullptr, 0) : workload.Quads(1, 256, 0, nullptr, 0);
+            path.Frame(drawData);
+            const int numChunks = path.wrapper.ctx->chunks.Size();
+            peakChunks = numChunks > peakChunks ? numChunks : peakChunks;
+            if ((dropFrame < 0) && (frameIndex > 0) && (1 == numChunks)) {
+                dropFrame = frameIndex;
+            }
+        }
+    });
+    if (runner.Enabled("chunks.spike")) {
+        // the spare chunks must be gone
+        o_assert(1 == path.wrapper.ctx->chunks.Size());
+        o_assert(dropFrame == setup.StreamIdleFrames);
+        runner.Counter("peak_chunks", peakChunks);
+        runner.Counter("drop_frame", dropFrame);
+        runner.Counter("chunks_after", path.wrapper.ctx->chunks.Size());
+    }
+    path.Discard();
+}
+
+//------------------------------------------------------------------------------
+static void
+benchParallelAssembly(benchRunner& runner, benchWorkload& workload) {
+    // the same large frame assembled serially and by 1..8 assembly
+    // workers, the threshold is lowered so that every chunk goes parallel
+    const int numWorkers[] = { 0, 1, 2, 4, 8 };
+    for (int num : numWorkers) {
+        IMUISetup setup;
+        setup.NumAssemblyWorkers = num;
+        setup.ParallelAssemblyMinVertices = 0;
+        char name[32];
+        snprintf(name, sizeof(name), "parallel.workers%d", num);
+        benchFrame(runner, name, "8 lists x 16k quads", setup, [&workload](benchRenderPath&) {
+            return workload.Quads(8, 16 * 1024, 0, nullptr, 0);
+        });
+        benchFrame(runner, name, "64 windows x 48 rows", setup, [&workload](benchRenderPath&) {
+            return workload.Widgets(64, 48);
+        });
+    }
+}
+
+//------------------------------------------------------------------------------
+static void
+benchPlots(benchRunner& runner, benchWorkload& workload) {
+    // CPU cost per frame of plotting large sample arrays: ImGui::PlotLines()
+    // tessellates the samples into the draw list (at most one segment per
+    // pixel of plot width), IMUI::PlotLinesGPU() packs all samples as
+    // instance data and adds a callback, the frame time includes the
+    // ImGui frame and the render path assembly
+    const int numPlots = 8;
+    const int sampleCounts[] = { 1024, 16 * 1024 };
+    for (int numSamples : sampleCounts) {
+        Array<float> values;
+        values.Reserve(numSamples);
+        for (int i = 0; i < numSamples; i++) {
+            values.Add(sinf(float(i) * 0.01f) + 0.25f * sinf(float(i) * 0.37f));
+        }
+        const float* valuePtr = &values[0];
+        char params[48];
+        snprintf(params, sizeof(params), "%d plots x %d samples", numPlots, numSamples);
+
+        benchRenderPath path;
+        path.Setup(IMUISetup());
+        int numVertices = 0;
+        if (runner.Enabled("plot.imgui_lines")) {
+            runner.Run("plot.imgui_lines", params, numPlots * numSamples, [&]() {
+                const ImDrawData* drawData = workload.Frame([&]() {
+                    for (int i = 0; i < numPlots; i++) {
+                        ImGui::PushID(i);
+                        ImGui::PlotLines("##plot", valuePtr, numSamples, 0, nullptr, FLT_MAX, FLT_MAX, ImVec2(0.0f, 64.0f));
+                        ImGui::PopID();
+                    }
+                });
+                path.Frame(drawData);
+                numVertices = drawData->TotalVtxCount;
+            });
+            runner.Counter("vertices", numVertices);
+        }
+        if (runner.Enabled("plot.gpu_lines")) {
+            runner.Run("plot.gpu_lines", params, numPlots * numSamples, [&]() {
+                path.wrapper.ctx->plots.Reset();
+                const ImDrawData* drawData = workload.Frame([&]() {
+                    for (int i = 0; i < numPlots; i++) {
+                        ImGui::PushID(i);
+                        path.wrapper.PlotGPU(imguiPlotRenderer::Lines, "##plot", valuePtr, numSamples, FLT_MAX, FLT_MAX, ImVec2(0.0f, 64.0f));
+                        ImGui::PopID();
+                    }
+                });
+                path.Frame(drawData);
+                numVertices = drawData->TotalVtxCount;
+            });
+            runner.Counter("vertices", numVertices);
+        }
+        path.Discard();
+    }
+}
+
+//------------------------------------------------------------------------------
+/// table rows computed from the row index (a time stamp and a scattered
+/// value), NumRows() grows while the table's worker thread reads rows
+class benchTableSource : public IMUITableSource {
+public:
+    std::atomic<int> numRows{0};
+
+    int NumRows() const override {
+        return this->numRows;
+    }
+    int NumColumns() const override {
+        return 2;
+    }
+    const char* ColumnName(int column) const override {
+        return (0 == column) ? "time" : "value";
+    }
+    void FormatCell(int row, int column, char* buf, int bufSize) const override {
+        snprintf(buf, bufSize, "%u", value(row, column));
+    }
+    int CompareRows(int rowA, int rowB, int column) const override {
+        const unsigned int a = value(rowA, column);
+        const unsigned int b = value(rowB, column);
+        return (a < b) ? -1 : ((a > b) ? 1 : 0);
+    }
+    static unsigned int value(int row, int column) {
+        return (0 == column) ? unsigned(row) : (unsigned(row) * 2654435761u) >> 8;
+    }
+};
+
+//------------------------------------------------------------------------------
+static void
+benchTable(benchRunner& runner, benchWorkload& workload) {
+    // frames of a table sorted by time while 1k rows are appended per
+    // frame: the new rows are sorted on the table's worker thread and
+    // merged in place, so the frame time must stay flat from 128k to
+    // 1M rows
+    const int numFrames = 120;
+    const int rowsPerFrame = 1024;
+    const int baseRowCounts[] = { 128 * 1024, 1024 * 1024 };
+    for (int numBaseRows : baseRowCounts) {
+        if (!runner.Enabled("table.append")) {
+            break;
+        }
+        benchTableSource source;
+        source.numRows = numBaseRows;
+        IMUITable table;
+        table.Setup(&source);
+        table.SortBy(0, true);
+        const auto draw = [&table]() {
+            table.Draw("table");
+        };
+        while (table.IsBusy() || (table.NumDisplayRows() < numBaseRows)) {
+            workload.Frame(draw);
+        }
+        Array<double> frameUs;
+        for (int frameIndex = 0; frameIndex < numFrames; frameIndex++) {
+            source.numRows += rowsPerFrame;
+            const TimePoint startTime = Clock::Now();
+            workload.Frame(draw);
+            frameUs.Add(Clock::Since(startTime).AsMicroSeconds());
+        }
+        char params[48];
+        snprintf(params, sizeof(params), "%dk rows + 1k/frame, sorted", numBaseRows / 1024);
+        runner.Record("table.append", params, rowsPerFrame, frameUs);
+        runner.Counter("rows_behind", source.NumRows() - table.NumDisplayRows());
+        table.Discard();
+    }
+
+    // a new sort order on 1M rows which is dropped right away, Discard()
+    // only waits until the sort notices the cancellation
+    benchTableSource source;
+    source.numRows = 1024 * 1024;
+    IMUITable table;
+    runner.Run("table.cancel_sort", "1M rows, sort by scattered value", 1, [&]() {
+        table.Setup(&source);
+        table.SortBy(1, true);
+        workload.Frame([&table]() {
+            table.Draw("table");
+        });
+        table.Discard();
+    });
+}
+
+//------------------------------------------------------------------------------
+static void
+benchInputStream(benchRunner& runner, benchWorkload& workload, const char* name, const char* params, int numFrames,
+                 const std::function<void(int frame, TimePoint time, Array<IMUIInputEvent>& events)>& generate) {
+    // feeds a synthetic event stream through the input event queue, one
+    // ImGui frame per stream frame, then runs frames until the queue is
+    // drained; the counters are the worst input-to-draw latency in
+    // frames, and how many frames after the end of the stream the
+    // deferred events needed
+    IMUISetup setup;
+    setup.InputEventQueue = true;
+    benchRenderPath path;
+    path.Setup(setup);
+    imguiWrapper& w = path.wrapper;
+    imguiWrapper::context& c = *w.ctx;
+    ImGui::GetIO().UserData = &c;
+    const int maxDrainFrames = 256;
+    int maxLatency = 0;
+    int drainFrames = 0;
+    int numEvents = 0;
+    int numDeferred = 0;
+    Array<IMUIInputEvent> events;
+    char text[64] = { };
+    const auto frame = [&]() {
+        c.frameIndex++;
+        c.frameStats = IMUIFrameStats();
+        w.applyInputEvents(c, false);
+        maxLatency = c.frameStats.InputLatencyFrames > maxLatency ? c.frameStats.InputLatencyFrames : maxLatency;
+        numDeferred += c.frameStats.NumInputEventsDeferred;
+        const ImDrawData* drawData = workload.Frame([&text]() {
+            ImGui::Button("button");
+            ImGui::InputText("text", text, sizeof(text));
+            ImGui::Text("mouse: %.1f, %.1f", ImGui::GetIO().MousePos.x, ImGui::GetIO().MousePos.y);
+        });
+        path.Frame(drawData);
+    };
+    runner.Run(name, params, numFrames, [&]() {
+        c.inputEvents.Clear();
+        maxLatency = drainFrames = numEvents = numDeferred = 0;
+        for (int frameIndex = 0; frameIndex < numFrames; frameIndex++) {
+            events.Clear();
+            generate(frameIndex, Clock::Now(), events);
+            for (const IMUIInputEvent& e : events) {
+                w.queueInputEvent(c, e);
+            }
+            numEvents += events.Size();
+            frame();
+        }
+        while (!c.inputEvents.Empty() && (drainFrames < maxDrainFrames)) {
+            frame();
+            drainFrames++;
+        }
+    });
+    if (runner.Enabled(name)) {
+        runner.Counter("events", numEvents);
+        runner.Counter("max_latency_frames", maxLatency);
+        runner.Counter("drain_frames", drainFrames);
+        runner.Counter("deferred_per_frame", double(numDeferred) / double(numFrames + drainFrames));
+    }
+    ImGui::GetIO().UserData = nullptr;
+    path.Discard();
+}
+
+//------------------------------------------------------------------------------
+static void
+benchInput(benchRunner& runner, benchWorkload& workload) {
+    const auto event = [](IMUIInputEvent::Type type, TimePoint time) {
+        IMUIInputEvent e;
+        e.EventType = type;
+        e.Time = time;
+        return e;
+    };
+    // a drag: 16 mouse moves per frame with the button held
+    benchInputStream(runner, workload, "input.drag", "120 frames, 16 moves/frame", 120,
+        [&event](int frame, TimePoint time, Array<IMUIInputEvent>& events) {
+            if (0 == frame) {
+                events.Add(event(IMUIInputEvent::MouseButtonDown, time));
+            }
+            for (int i = 0; i < 16; i++) {
+                IMUIInputEvent e = event(IMUIInputEvent::MouseMove, time);
+                e.X = float(frame * 16 + i);
+                e.Y = 100.0f;
+                events.Add(e);
+            }
+            if (119 == frame) {
+                events.Add(event(IMUIInputEvent::MouseButtonUp, time));
+            }
+        });
+    // fast clicking: 2 clicks per frame with moves in between, each
+    // second button change is deferred, so the queue grows
+    benchInputStream(runner, workload, "input.fast_clicks", "60 frames, 2 clicks/frame", 60,
+        [&event](int frame, TimePoint time, Array<IMUIInputEvent>& events) {
+            for (int i = 0; i < 2; i++) {
+                IMUIInputEvent move = event(IMUIInputEvent::MouseMove, time);
+                move.X = float(10 + (frame * 2 + i) % 200);
+                move.Y = 10.0f;
+                events.Add(move);
+                events.Add(event(IMUIInputEvent::MouseButtonDown, time));
+                events.Add(event(IMUIInputEvent::MouseButtonUp, time));
+            }
+        });
+    // typing: 4 keys per frame with their characters, and mouse moves
+    // which are not held back by the key changes
+    benchInputStream(runner, workload, "input.typing", "120 frames, 4 keys/frame", 120,
+        [&event](int frame, TimePoint time, Array<IMUIInputEvent>& events) {
+            for (int i = 0; i < 4; i++) {
+                const int letter = (frame * 4 + i) % 26;
+                IMUIInputEvent down = event(IMUIInputEvent::KeyDown, time);
+                down.Code = Key::A + letter;
+                events.Add(down);
+                IMUIInputEvent chr = event(IMUIInputEvent::Char, time);
+                chr.CharCode = wchar_t('a' + letter);
+                events.Add(chr);
+                IMUIInputEvent up = event(IMUIInputEvent::KeyUp, time);
+                up.Code = Key::A + letter;
+                events.Add(up);
+                IMUIInputEvent move = event(IMUIInputEvent::MouseMove, time);
+                move.X = float(frame);
+                move.Y = float(i);
+                events.Add(move);
+            }
+        });
+}
+
+//------------------------------------------------------------------------------
+static bool
+benchReplay(benchRunner& runner, const char* path) {
+    // each frame of the capture is timed once (delta frames depend on
+    // their predecessor, so the frames are replayed in order)
+    imguiCapture capture;
+    if (!capture.BeginRead(path)) {
+        fprintf(stderr, "IMUIBench: failed to open capture file '%s'\n", path);
+        return false;
+    }
+    benchRenderPath renderPath;
+    renderPath.Setup(IMUISetup());
+    Array<double> frameUs;
+    int totalVertices = 0;
+    int maxVertices = 0;
+    int maxChunks = 0;
+    ImVec2 displaySize;
+    while (capture.ReadFrame(displaySize, benchWorkload::FontTexId())) {
+        const ImDrawData* drawData = capture.DrawData();
+        const TimePoint startTime = Clock::Now();
+        renderPath.Frame(drawData);
+        frameUs.Add(Clock::Since(startTime).AsMicroSeconds());
+        totalVertices += drawData->TotalVtxCount;
+        maxVertices = drawData->TotalVtxCount > maxVertices ? drawData->TotalVtxCount : maxVertices;
+        maxChunks = renderPath.Stats().NumChunks > maxChunks ? renderPath.Stats().NumChunks : maxChunks;
+    }
+    capture.EndRead();
+    renderPath.Discard();
+    if (frameUs.Empty()) {
+        fprintf(stderr, "IMUIBench: no frames in capture file '%s'\n", path);
+        return false;
+    }
+    runner.Record("replay.frame", path, totalVertices / frameUs.Size(), frameUs);
+    runner.Counter("frames", frameUs.Size());
+    runner.Counter("max_vertices", maxVertices);
+    runner.Counter("max_chunks", maxChunks);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+int
+main(int argc, const char** argv) {
+    benchRunner runner;
+    if (!runner.Setup(argc, argv)) {
+        return 10;
+    }
+    printf("IMUIBench (simd: %s, %d iterations)\n", imguiKernels::SimdName(), runner.Iterations);
+
+    benchWorkload workload;
+    workload.Setup();
+    if (runner.ReplayPath.IsValid()) {
+        const bool replayed = benchReplay(runner, runner.ReplayPath.AsCStr());
+        workload.Discard();
+        return (replayed && runner.Finish()) ? 0 : 10;
+    }
+    benchKernels(runner);
+    benchRebase(runner);
+    benchImagePool(runner);
+    benchRenderPaths(runner, workload);
+    benchChunkSpike(runner, workload);
+    benchPlots(runner, workload);
+    benchInput(runner, workload);
+    benchTable(runner, workload);
+    #if ORYOL_HAS_THREADS
+    benchParallelAssembly(runner, workload);
+    #endif
+    workload.Discard();
+
+    return runner.Finish() ? 0 : 10;
+}
@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+//  benchRenderPath.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "benchRenderPath.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include "IMUI/imguiKernels.h"
+#include "benchWorkload.h"
+
+namespace Oryol {
+
+using namespace _priv;
+
+//------------------------------------------------------------------------------
+void
+benchRenderPath::Setup(const IMUISetup& setup) {
+    imguiWrapper& w = this->wrapper;
+    w.setup = setup;
+    w.headless = true;
+    w.vertexSize = setup.CompactVertices ? sizeof(imguiCompactVertex) : sizeof(ImDrawVert);
+    w.setupStaging();
+    w.resizeStaging(w.maxChunkVertices, w.maxChunkIndices);
+    w.imagePool.Setup(imguiWrapper::InitialImageCapacity);
+    if (setup.ImageAtlas) {
+        w.imageAtlas.Setup(setup.ImageAtlasPageSize, setup.ImageAtlasMaxImageSize, setup.ImageAtlasMaxPages);
+    }
+    if (setup.NumAssemblyWorkers > 0) {
+        w.workerPool.Setup(setup.NumAssemblyWorkers);
+    }
+    w.ctx = Memory::New<imguiWrapper::context>();
+    w.contexts.Add(w.ctx);
+    // a made-up quad mesh, so that PlotGPU() records GPU plots instead
+    // of falling back to ImGui::PlotLines()
+    w.plotQuadMesh = Id(Id::UniqueStampT(1), Id::SlotIndexT(0), GfxResourceType::Mesh);
+    this->numImages = 0;
+
+    // the first handle of a fresh image pool is the one the workload
+    // uses as font texture, so font draw commands use the font pipeline
+    const ImTextureID fontImg = this->AllocImage();
+    o_assert(fontImg == benchWorkload::FontTexId());
+    w.fontTexture = w.imagePool.Lookup(fontImg)->texture;
+}
+
+//------------------------------------------------------------------------------
+void
+benchRenderPath::Discard() {
+    imguiWrapper& w = this->wrapper;
+    Memory::Delete(w.ctx);
+    w.ctx = nullptr;
+    w.contexts.Clear();
+    w.workerPool.Discard();
+    if (w.imageAtlas.IsValid()) {
+        // the atlas pages never got a texture, Discard() only frees the pixels
+        w.imageAtlas.Discard();
+    }
+    w.imagePool.Discard();
+    w.discardStaging();
+}
+
+//------------------------------------------------------------------------------
+ImTextureID
+benchRenderPath::AllocImage() {
+    ImTextureID img = this->wrapper.imagePool.Alloc();
+    const int index = this->numImages++;
+    this->wrapper.imagePool.Bind(img, Id(Id::UniqueStampT(index + 1), Id::SlotIndexT(index), GfxResourceType::Texture));
+    return img;
+}
+
+//------------------------------------------------------------------------------
+ImTextureID
+benchRenderPath::AllocAtlasImage(int width, int height) {
+    o_assert(this->wrapper.imageAtlas.IsValid());
+    const int numBytes = width * height * 4;
+    void* pixels = Memory::Alloc(numBytes);
+    Memory::Clear(pixels, numBytes);
+    int page = 0;
+    ImVec2 uvOffset, uvScale;
+    const bool added = this->wrapper.imageAtlas.Add(pixels, width, height, page, uvOffset, uvScale);
+    o_assert(added);
+    (void)added;
+    Memory::Free(pixels);
+    ImTextureID img = this->wrapper.imagePool.Alloc();
+    this->wrapper.imagePool.BindAtlasRegion(img, page, uvOffset, uvScale);
+    return img;
+}
+
+//------------------------------------------------------------------------------
+int
+benchRenderPath::AssignChunks(const ImDrawData* drawData) {
+    this->wrapper.ctx->frameStats = IMUIFrameStats();
+    const int numChunks = this->wrapper.assignChunks(drawData);
+    this->wrapper.ctx->frameStats.NumChunks = numChunks;
+    return numChunks;
+}
+
+//------------------------------------------------------------------------------
+void
+benchRenderPath::Assemble(const ImDrawData* drawData, int numChunks) {
+    for (int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++) {
+        this->wrapper.assembleChunk(drawData, chunkIndex);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+benchRenderPath::BuildBatches(const ImDrawData* drawData, int numChunks) {
+    this->wrapper.buildBatches(drawData, numChunks);
+}
+
+//------------------------------------------------------------------------------
+void
+benchRenderPath::Frame(const ImDrawData* drawData) {
+    const int numChunks = this->AssignChunks(drawData);
+    this->wrapper.updateChunkCapacities(numChunks);
+    this->Assemble(drawData, numChunks);
+    this->BuildBatches(drawData, numChunks);
+}
+
+//------------------------------------------------------------------------------
+const IMUIFrameStats&
+benchRenderPath::Stats() const {
+    return this->wrapper.ctx->frameStats;
+}
+
+} // namespace Oryol
@@ -0,0 +1,49 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::benchRenderPath
+    @brief drives the CPU part of the IMUI render path without Gfx
+
+    Sets up an imguiWrapper with staging buffers, image pool, image
+    atlas and worker pool, but without any Gfx resources, and runs the
+    same chunk assignment, chunk capacity tracking, vertex/index
+    assembly and draw batching code as the IMUI render callback (the
+    wrapper runs headless, so stream chunks get no meshes). Images
+    are bound to made-up texture ids which are only compared, never
+    passed to Gfx. GPU plots are recorded (wrapper.PlotGPU()) but
+    never uploaded.
+*/
+#include "Core/Types.h"
+#include "IMUI/imguiWrapper.h"
+
+namespace Oryol {
+
+class benchRenderPath {
+public:
+    /// setup the wrapper's CPU-side state
+    void Setup(const IMUISetup& setup);
+    /// discard the wrapper's CPU-side state
+    void Discard();
+
+    /// allocate an image handle bound to a made-up texture
+    ImTextureID AllocImage();
+    /// allocate an image handle and put a blank image into the image atlas
+    ImTextureID AllocAtlasImage(int width, int height);
+
+    /// run assignChunks(), updateChunkCapacities(), assembleChunk() and buildBatches() for a frame
+    void Frame(const ImDrawData* drawData);
+    /// distribute the draw lists over stream chunks (resets the frame stats)
+    int AssignChunks(const ImDrawData* drawData);
+    /// assemble the vertices and indices of all chunks into the staging buffers
+    void Assemble(const ImDrawData* drawData, int numChunks);
+    /// merge the draw commands into draw batches
+    void BuildBatches(const ImDrawData* drawData, int numChunks);
+    /// get the counters of the last frame
+    const IMUIFrameStats& Stats() const;
+
+    _priv::imguiWrapper wrapper;
+private:
+    int numImages = 0;
+};
+
+} // namespace Oryol
@@ -0,0 +1,152 @@
+//------------------------------------------------------------------------------
+//  benchRunner.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "benchRunner.h"
+#include "Core/Assertion.h"
+#include "Core/Time/Clock.h"
+#include "IMUI/imguiKernels.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+bool
+benchRunner::Setup(int argc, const char** argv) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* val = (i + 1) < argc ? argv[i + 1] : nullptr;
+        if (0 == strcmp(arg, "--json") && val) {
+            this->JsonPath = val;
+            i++;
+        }
+        else if (0 == strcmp(arg, "--iterations") && val) {
+            this->Iterations = atoi(val);
+            i++;
+        }
+        else if (0 == strcmp(arg, "--filter") && val) {
+            this->filter = val;
+            i++;
+        }
+        else if (0 == strcmp(arg, "--replay") && val) {
+            this->ReplayPath = val;
+            i++;
+        }
+        else {
+            fprintf(stderr, "usage: IMUIBench [--json path] [--iterations n] [--filter text] [--replay capture]\n");
+            return false;
+        }
+    }
+    if (this->Iterations < 1) {
+        this->Iterations = 1;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool
+benchRunner::Enabled(const char* name) const {
+    return !this->filter.IsValid() || (nullptr != strstr(name, this->filter.AsCStr()));
+}
+
+//------------------------------------------------------------------------------
+void
+benchRunner::Run(const char* name, const char* params, int workItems, const std::function<void()>& func) {
+    if (!this->Enabled(name)) {
+        return;
+    }
+    // the first run warms up caches and lazily allocated buffers
+    func();
+    Array<double> runs;
+    runs.Reserve(this->Iterations);
+    for (int i = 0; i < this->Iterations; i++) {
+        const TimePoint startTime = Clock::Now();
+        func();
+        runs.Add(Clock::Since(startTime).AsMicroSeconds());
+    }
+    this->Record(name, params, workItems, runs);
+}
+
+//------------------------------------------------------------------------------
+void
+benchRunner::Record(const char* name, const char* params, int workItems, const Array<double>& runMicroSeconds) {
+    o_assert_dbg(!runMicroSeconds.Empty());
+    Array<double> sorted = runMicroSeconds;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (double us : sorted) {
+        sum += us;
+    }
+    result& res = this->results.Add();
+    res.name = name;
+    res.params = params;
+    res.iterations = sorted.Size();
+    res.workItems = workItems;
+    res.minUs = sorted[0];
+    res.medianUs = sorted[sorted.Size() / 2];
+    res.meanUs = sum / sorted.Size();
+    printf("%-28s %-36s %10.2f us (min %.2f, mean %.2f)\n", name, params, res.medianUs, res.minUs, res.meanUs);
+}
+
+//------------------------------------------------------------------------------
+void
+benchRunner::Counter(const char* name, double value) {
+    o_assert_dbg(!this->results.Empty());
+    counter& c = this->results.Back().counters.Add();
+    c.name = name;
+    c.value = value;
+    printf("%-28s   %s: %g\n", "", name, value);
+}
+
+//------------------------------------------------------------------------------
+static void
+writeString(FILE* fp, const char* str) {
+    fputc('"', fp);
+    for (; *str; str++) {
+        if (('"' == *str) || ('\\' == *str)) {
+            fputc('\\', fp);
+        }
+        fputc(*str, fp);
+    }
+    fputc('"', fp);
+}
+
+//------------------------------------------------------------------------------
+bool
+benchRunner::Finish() {
+    if (!this->JsonPath.IsValid()) {
+        return true;
+    }
+    FILE* fp = fopen(this->JsonPath.AsCStr(), "w");
+    if (!fp) {
+        fprintf(stderr, "IMUIBench: failed to open '%s'\n", this->JsonPath.AsCStr());
+        return false;
+    }
+    fprintf(fp, "{\n  \"simd\": ");
+    writeString(fp, _priv::imguiKernels::SimdName());
+    fprintf(fp, ",\n  \"iterations\": %d,\n  \"results\": [", this->Iterations);
+    for (int i = 0; i < this->results.Size(); i++) {
+        const result& res = this->results[i];
+        fprintf(fp, "%s\n    {\"name\": ", i > 0 ? "," : "");
+        writeString(fp, res.name.AsCStr());
+        fprintf(fp, ", \"params\": ");
+        writeString(fp, res.params.AsCStr());
+        fprintf(fp, ", \"iterations\": %d, \"work_items\": %d, \"min_us\": %.3f, \"median_us\": %.3f, \"mean_us\": %.3f, \"counters\": {",
+            res.iterations, res.workItems, res.minUs, res.medianUs, res.meanUs);
+        for (int c = 0; c < res.counters.Size(); c++) {
+            fprintf(fp, "%s", c > 0 ? ", " : "");
+            writeString(fp, res.counters[c].name.AsCStr());
+            fprintf(fp, ": %g", res.counters[c].value);
+        }
+        fprintf(fp, "}}");
+    }
+    fprintf(fp, "\n  ]\n}\n");
+    const bool ok = 0 == ferror(fp);
+    fclose(fp);
+    return ok;
+}
+
+} // namespace Oryol
@@ -0,0 +1,67 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::benchRunner
+    @brief times benchmark scenarios and writes the results as JSON
+
+    Each scenario is run once to warm up, then Iterations times. The
+    result records min, median and mean time per run, the number of
+    work items per run (vertices, glyphs, events, ...) and any counters
+    attached with Counter().
+
+    Command line options:
+
+    --json <path>       write the results to a JSON file
+    --iterations <n>    timed runs per scenario (default 20)
+    --filter <text>     only run scenarios whose name contains text
+    --replay <path>     replay a capture file (see IMUI::BeginCapture())
+*/
+#include "Core/Types.h"
+#include "Core/String/String.h"
+#include "Core/Containers/Array.h"
+#include <functional>
+
+namespace Oryol {
+
+class benchRunner {
+public:
+    /// parse the command line, returns false on bad arguments
+    bool Setup(int argc, const char** argv);
+    /// return true if a scenario passes the --filter option
+    bool Enabled(const char* name) const;
+    /// time a scenario and record the result
+    void Run(const char* name, const char* params, int workItems, const std::function<void()>& func);
+    /// record a time measured by the scenario itself (e.g. a replayed frame)
+    void Record(const char* name, const char* params, int workItems, const Array<double>& runMicroSeconds);
+    /// attach a counter to the last recorded result
+    void Counter(const char* name, double value);
+    /// print a summary and write the JSON file, returns false if writing failed
+    bool Finish();
+
+    /// number of timed runs per scenario
+    int Iterations = 20;
+    /// JSON output path (empty: no file)
+    String JsonPath;
+    /// capture file to replay (empty: no replay)
+    String ReplayPath;
+
+private:
+    struct counter {
+        String name;
+        double value = 0.0;
+    };
+    struct result {
+        String name;
+        String params;
+        int iterations = 0;
+        int workItems = 0;
+        double minUs = 0.0;
+        double medianUs = 0.0;
+        double meanUs = 0.0;
+        Array<counter> counters;
+    };
+    String filter;
+    Array<result> results;
+};
+
+} // namespace Oryol
@@ -0,0 +1,165 @@
+//------------------------------------------------------------------------------
+//  benchWorkload.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "benchWorkload.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include <cstdio>
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+void
+benchWorkload::Setup() {
+    o_assert_dbg(nullptr == this->context);
+    this->context = ImGui::CreateContext();
+    ImGui::SetCurrentContext(this->context);
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.LogFilename = nullptr;
+    io.DisplaySize = ImVec2(float(DisplayWidth), float(DisplayHeight));
+    io.DeltaTime = 1.0f / 60.0f;
+    unsigned char* pixels = nullptr;
+    int width = 0, height = 0;
+    io.Fonts->GetTexDataAsAlpha8(&pixels, &width, &height);
+    io.Fonts->TexID = FontTexId();
+
+    // an empty frame initializes the shared draw list data (white
+    // pixel uv, fullscreen clip rect) which Quads() relies on
+    ImGui::NewFrame();
+    ImGui::Render();
+}
+
+//------------------------------------------------------------------------------
+void
+benchWorkload::Discard() {
+    o_assert_dbg(this->context);
+    for (ImDrawList* list : this->drawLists) {
+        Memory::Delete(list);
+    }
+    this->drawLists.Clear();
+    this->cmdLists.Clear();
+    this->drawData = ImDrawData();
+    ImGui::DestroyContext(this->context);
+    this->context = nullptr;
+}
+
+//------------------------------------------------------------------------------
+ImDrawData*
+benchWorkload::Widgets(int numWindows, int numWidgets) {
+    o_assert_dbg(this->context);
+    ImGuiIO& io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(float(DisplayWidth), float(DisplayHeight));
+    io.DeltaTime = 1.0f / 60.0f;
+    ImGui::NewFrame();
+
+    // windows are laid out in a grid which covers the display
+    const int numColumns = 8;
+    const int numRows = (numWindows + numColumns - 1) / numColumns;
+    const float winWidth = float(DisplayWidth) / numColumns;
+    const float winHeight = float(DisplayHeight) / (numRows > 0 ? numRows : 1);
+    for (int winIndex = 0; winIndex < numWindows; winIndex++) {
+        char name[32];
+        snprintf(name, sizeof(name), "window %d", winIndex);
+        ImGui::SetNextWindowPos(ImVec2((winIndex % numColumns) * winWidth, (winIndex / numColumns) * winHeight), ImGuiCond_Always);
+        ImGui::SetNextWindowSize(ImVec2(winWidth, winHeight), ImGuiCond_Always);
+        ImGui::Begin(name);
+        for (int i = 0; i < numWidgets; i++) {
+            ImGui::PushID(i);
+            switch (i % 5) {
+                case 0:
+                    ImGui::Text("row %d: the quick brown fox jumps over the lazy dog", i);
+                    break;
+                case 1:
+                    ImGui::Button("Button");
+                    break;
+                case 2: {
+                    float value = float(i % 100);
+                    ImGui::SliderFloat("slider", &value, 0.0f, 100.0f);
+                    break;
+                }
+                case 3: {
+                    bool checked = 0 != (i & 8);
+                    ImGui::Checkbox("checkbox", &checked);
+                    break;
+                }
+                default:
+                    // columns draw into separate draw list channels
+                    ImGui::Columns(3, "columns");
+                    for (int col = 0; col < 3; col++) {
+                        ImGui::Text("cell %d.%d", i, col);
+                        ImGui::NextColumn();
+                    }
+                    ImGui::Columns(1);
+                    break;
+            }
+            ImGui::PopID();
+        }
+        ImGui::End();
+    }
+    ImGui::Render();
+    return ImGui::GetDrawData();
+}
+
+//------------------------------------------------------------------------------
+ImDrawData*
+benchWorkload::Frame(const std::function<void()>& buildWindow) {
+    o_assert_dbg(this->context);
+    ImGuiIO& io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(float(DisplayWidth), float(DisplayHeight));
+    io.DeltaTime = 1.0f / 60.0f;
+    ImGui::NewFrame();
+    ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f), ImGuiCond_Always);
+    ImGui::SetNextWindowSize(io.DisplaySize, ImGuiCond_Always);
+    ImGui::Begin("bench");
+    buildWindow();
+    ImGui::End();
+    ImGui::Render();
+    return ImGui::GetDrawData();
+}
+
+//------------------------------------------------------------------------------
+ImDrawData*
+benchWorkload::Quads(int numLists, int numQuads, int quadsPerImage, const ImTextureID* images, int numImages) {
+    o_assert_dbg(this->context);
+    // 16-bit indices limit a draw list to 64k vertices
+    o_assert((numQuads > 0) && ((numQuads * 4) <= 0x10000));
+    o_assert((0 == quadsPerImage) || (images && (numImages > 0)));
+    while (this->drawLists.Size() < numLists) {
+        this->drawLists.Add(Memory::New<ImDrawList>(ImGui::GetDrawListSharedData()));
+    }
+    this->cmdLists.Clear();
+    int totalVertices = 0;
+    int totalIndices = 0;
+    for (int listIndex = 0; listIndex < numLists; listIndex++) {
+        ImDrawList* list = this->drawLists[listIndex];
+        list->Clear();
+        list->PushClipRectFullScreen();
+        list->PushTextureID(FontTexId());
+        for (int quad = 0; quad < numQuads; quad++) {
+            const ImVec2 a(float((quad % 256) * 16), float(((quad / 256) % 256) * 16));
+            const ImVec2 b(a.x + 12.0f, a.y + 12.0f);
+            if ((quadsPerImage > 0) && ((quad % quadsPerImage) == (quadsPerImage - 1))) {
+                list->AddImage(images[(quad / quadsPerImage) % numImages], a, b);
+            }
+            else {
+                list->AddRectFilled(a, b, 0xFF00FF00 | (quad & 0xFF));
+            }
+        }
+        list->PopTextureID();
+        list->PopClipRect();
+        this->cmdLists.Add(list);
+        totalVertices += list->VtxBuffer.size();
+        totalIndices += list->IdxBuffer.size();
+    }
+    this->drawData = ImDrawData();
+    this->drawData.Valid = true;
+    this->drawData.CmdLists = this->cmdLists.Empty() ? nullptr : &this->cmdLists[0];
+    this->drawData.CmdListsCount = this->cmdLists.Size();
+    this->drawData.TotalVtxCount = totalVertices;
+    this->drawData.TotalIdxCount = totalIndices;
+    return &this->drawData;
+}
+
+} // namespace Oryol
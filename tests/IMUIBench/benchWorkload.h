@@ -0,0 +1,51 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::benchWorkload
+    @brief generates synthetic ImDrawData for the IMUI benchmarks
+
+    Widgets() runs a real ImGui frame (text, buttons, sliders and column
+    tables, so the draw lists also contain merged draw list channels).
+    Quads() fills draw lists directly with rectangles and images, which
+    gives exact control over vertex counts and texture changes.
+
+    All of it is CPU-only: the ImGui context gets a built font atlas
+    but no renderer, no Gfx setup is needed.
+*/
+#include "Core/Types.h"
+#include "Core/Containers/Array.h"
+#include "imgui.h"
+#include <functional>
+
+namespace Oryol {
+
+class benchWorkload {
+public:
+    /// create the ImGui context and build its font atlas
+    void Setup();
+    /// destroy the ImGui context and the generated draw lists
+    void Discard();
+
+    /// run an ImGui frame with numWindows windows of numWidgets widget rows each
+    ImDrawData* Widgets(int numWindows, int numWidgets);
+    /// run an ImGui frame with a single fullscreen window whose content is built by a callback
+    ImDrawData* Frame(const std::function<void()>& buildWindow);
+    /// fill numLists draw lists with numQuads rects each, every quadsPerImage'th quad is an image (0: no images)
+    ImDrawData* Quads(int numLists, int numQuads, int quadsPerImage, const ImTextureID* images, int numImages);
+
+    /// the ImTextureID of the font atlas (the first handle of a fresh image pool)
+    static ImTextureID FontTexId() {
+        return (ImTextureID) 1;
+    }
+    /// display size of the generated frames
+    static const int DisplayWidth = 4096;
+    static const int DisplayHeight = 4096;
+
+private:
+    ImGuiContext* context = nullptr;
+    Array<ImDrawList*> drawLists;
+    Array<ImDrawList*> cmdLists;
+    ImDrawData drawData;
+};
+
+} // namespace Oryol